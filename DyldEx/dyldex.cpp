@@ -1,6 +1,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 #include <argparse/argparse.hpp>
 #include <spdlog/spdlog.h>
@@ -28,6 +29,10 @@ struct ProgramArguments {
   std::optional<std::string> extractImage;
   std::optional<fs::path> outputPath;
   bool imbedVersion;
+  unsigned int threads;
+  bool fastDisasm;
+  bool lazySymbols;
+  bool mergeStrings;
 
   union {
     uint32_t raw;
@@ -77,6 +82,29 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
       .default_value(false)
       .implicit_value(true);
 
+  program.add_argument("-t", "--threads")
+      .help("The maximum number of threads used while processing an image.")
+      .scan<'d', int>()
+      .default_value((int)std::max(std::thread::hardware_concurrency(), 1u));
+
+  program.add_argument("--fast-disasm")
+      .help("Use the builtin arm64 decoder instead of Capstone. Faster, but "
+            "less precise when telling data apart from code.")
+      .default_value(false)
+      .implicit_value(true);
+
+  program.add_argument("--lazy-symbols")
+      .help("Only symbolize exports of dependencies when they are needed. "
+            "Faster for images that link large frameworks.")
+      .default_value(false)
+      .implicit_value(true);
+
+  program.add_argument("--merge-strings")
+      .help("Merge strings that are suffixes of other strings in the string "
+            "pool. Makes the linkedit smaller, but takes longer.")
+      .default_value(false)
+      .implicit_value(true);
+
   ProgramArguments args;
   try {
     program.parse_args(argc, argv);
@@ -89,6 +117,10 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
     args.outputPath = program.present<std::string>("--output");
     args.modulesDisabled.raw = program.get<int>("--skip-modules");
     args.imbedVersion = program.get<bool>("--imbed-version");
+    args.threads = (unsigned int)std::max(program.get<int>("--threads"), 1);
+    args.fastDisasm = program.get<bool>("--fast-disasm");
+    args.lazySymbols = program.get<bool>("--lazy-symbols");
+    args.mergeStrings = program.get<bool>("--merge-strings");
   } catch (const std::runtime_error &err) {
     std::cerr << "Argument parsing error: " << err.what() << std::endl;
     std::exit(1);
@@ -171,6 +203,12 @@ void extractImage(Dyld::Context &dCtx, ProgramArguments args) {
 
   Provider::Accelerator<P> accelerator;
   Utils::ExtractionContext<A> eCtx(dCtx, mCtx, accelerator, activity);
+  eCtx.options.threads = args.threads;
+  if (args.fastDisasm) {
+    eCtx.options.disasmEngine = Provider::DisasmEngine::builtin;
+  }
+  eCtx.options.lazySymbols = args.lazySymbols;
+  eCtx.options.mergeStrings = args.mergeStrings;
 
   // Process
   if (!args.modulesDisabled.processSlideInfo) {
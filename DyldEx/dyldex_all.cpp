@@ -1,6 +1,7 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <thread>
 
 #include <argparse/argparse.hpp>
 #include <spdlog/spdlog.h>
@@ -29,6 +30,10 @@ struct ProgramArguments {
   bool disableOutput;
   bool onlyValidate;
   bool imbedVersion;
+  unsigned int threads;
+  bool fastDisasm;
+  bool lazySymbols;
+  bool mergeStrings;
 
   union {
     uint32_t raw;
@@ -78,6 +83,29 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
       .default_value(false)
       .implicit_value(true);
 
+  program.add_argument("-t", "--threads")
+      .help("The maximum number of threads used while processing an image.")
+      .scan<'d', int>()
+      .default_value((int)std::max(std::thread::hardware_concurrency(), 1u));
+
+  program.add_argument("--fast-disasm")
+      .help("Use the builtin arm64 decoder instead of Capstone. Faster, but "
+            "less precise when telling data apart from code.")
+      .default_value(false)
+      .implicit_value(true);
+
+  program.add_argument("--lazy-symbols")
+      .help("Only symbolize exports of dependencies when they are needed. "
+            "Faster for images that link large frameworks.")
+      .default_value(false)
+      .implicit_value(true);
+
+  program.add_argument("--merge-strings")
+      .help("Merge strings that are suffixes of other strings in the string "
+            "pool. Makes the linkedit smaller, but takes longer.")
+      .default_value(false)
+      .implicit_value(true);
+
   ProgramArguments args;
   try {
     program.parse_args(argc, argv);
@@ -89,6 +117,10 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
     args.onlyValidate = program.get<bool>("--only-validate");
     args.modulesDisabled.raw = program.get<int>("--skip-modules");
     args.imbedVersion = program.get<bool>("--imbed-version");
+    args.threads = (unsigned int)std::max(program.get<int>("--threads"), 1);
+    args.fastDisasm = program.get<bool>("--fast-disasm");
+    args.lazySymbols = program.get<bool>("--lazy-symbols");
+    args.mergeStrings = program.get<bool>("--merge-strings");
 
   } catch (const std::runtime_error &err) {
     std::cerr << "Argument parsing error: " << err.what() << std::endl;
@@ -107,12 +139,15 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
 template <class A>
 void runImage(Dyld::Context &dCtx,
               Provider::Accelerator<typename A::P> &accelerator,
+              Provider::ActivityLogger &activity,
+              std::optional<Macho::Context<false, typename A::P>> &machoCtx,
+              std::optional<Utils::ExtractionContext<A>> &eCtx,
               const dyld_cache_image_info *imageInfo,
-              const std::string imagePath, const std::string imageName,
-              const ProgramArguments &args, std::ostream &logStream) {
+              const std::string imagePath, const ProgramArguments &args) {
 
-  // validate
-  auto mCtx = dCtx.createMachoCtx<false, typename A::P>(imageInfo);
+  // validate, the context is kept with eCtx which points to it
+  auto &mCtx =
+      machoCtx.emplace(dCtx.createMachoCtx<false, typename A::P>(imageInfo));
   try {
     Provider::Validator<typename A::P>(mCtx).validate();
   } catch (const std::exception &e) {
@@ -124,32 +159,34 @@ void runImage(Dyld::Context &dCtx,
     return;
   }
 
-  // Setup context
-  Provider::ActivityLogger activity("DyldEx_" + imageName, logStream, false);
+  // Setup context, reusing the one from the previous image if possible
   auto logger = activity.getLogger();
-  logger->set_pattern("[%-8l %s:%#] %v");
-  if (args.verbose) {
-    logger->set_level(spdlog::level::trace);
+  if (eCtx) {
+    eCtx->reset(mCtx);
   } else {
-    logger->set_level(spdlog::level::info);
+    eCtx.emplace(dCtx, mCtx, accelerator, activity);
+    eCtx->options.threads = args.threads;
+    if (args.fastDisasm) {
+      eCtx->options.disasmEngine = Provider::DisasmEngine::builtin;
+    }
+    eCtx->options.lazySymbols = args.lazySymbols;
+    eCtx->options.mergeStrings = args.mergeStrings;
   }
 
-  Utils::ExtractionContext<A> eCtx(dCtx, mCtx, accelerator, activity);
-
   if (!args.modulesDisabled.processSlideInfo) {
-    Converter::processSlideInfo(eCtx);
+    Converter::processSlideInfo(*eCtx);
   }
   if (!args.modulesDisabled.optimizeLinkedit) {
-    Converter::optimizeLinkedit(eCtx);
+    Converter::optimizeLinkedit(*eCtx);
   }
   if (!args.modulesDisabled.fixStubs) {
-    Converter::fixStubs(eCtx);
+    Converter::fixStubs(*eCtx);
   }
   if (!args.modulesDisabled.fixObjc) {
-    Converter::fixObjc(eCtx);
+    Converter::fixObjc(*eCtx);
   }
   if (!args.modulesDisabled.generateMetadata) {
-    Converter::generateMetadata(eCtx);
+    Converter::generateMetadata(*eCtx);
   }
   if (args.imbedVersion) {
     if constexpr (!std::is_same_v<typename A::P, Utils::Arch::Pointer64>) {
@@ -161,7 +198,7 @@ void runImage(Dyld::Context &dCtx,
   }
 
   if (!args.disableOutput) {
-    auto writeProcedures = Converter::optimizeOffsets(eCtx);
+    auto writeProcedures = Converter::optimizeOffsets(*eCtx);
 
     auto outputPath = *args.outputDir / imagePath.substr(1); // remove leading /
     fs::create_directories(outputPath.parent_path());
@@ -195,6 +232,19 @@ void runAllImages(Dyld::Context &dCtx, ProgramArguments &args) {
 
   Provider::Accelerator<typename A::P> accelerator;
 
+  // Shared by all images, logs are collected and cleared after each one
+  std::ostringstream loggerStream;
+  Provider::ActivityLogger imageActivity("DyldEx_Image", loggerStream, false);
+  auto imageLogger = imageActivity.getLogger();
+  imageLogger->set_pattern("[%-8l %s:%#] %v");
+  if (args.verbose) {
+    imageLogger->set_level(spdlog::level::trace);
+  } else {
+    imageLogger->set_level(spdlog::level::info);
+  }
+  std::optional<Macho::Context<false, typename A::P>> mCtx;
+  std::optional<Utils::ExtractionContext<A>> eCtx;
+
   const int numberOfImages = (int)dCtx.images.size();
   for (int i = 0; i < numberOfImages; i++) {
     const auto imageInfo = dCtx.images[i];
@@ -205,12 +255,12 @@ void runAllImages(Dyld::Context &dCtx, ProgramArguments &args) {
     activity.update(std::nullopt, fmt::format("[{:4}/{}] {}", imagesProcessed,
                                               numberOfImages, imageName));
 
-    std::ostringstream loggerStream;
-    runImage<A>(dCtx, accelerator, imageInfo, imagePath, imageName, args,
-                loggerStream);
+    runImage<A>(dCtx, accelerator, imageActivity, mCtx, eCtx, imageInfo,
+                imagePath, args);
 
     // update summary and UI.
     auto logs = loggerStream.str();
+    loggerStream.str("");
     activity.getLoggerStream()
         << fmt::format("processed {}", imageName) << std::endl
         << logs << std::endl;
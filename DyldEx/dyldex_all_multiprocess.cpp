@@ -447,56 +447,53 @@ getImageName(Dyld::Context &dCtx, const dyld_cache_image_info *image) {
 }
 
 template <class A>
-std::ostringstream
-processImage(ProgramArguments &args, Dyld::Context &dCtx,
-             Provider::Accelerator<typename A::P> &accelerator,
-             const dyld_cache_image_info *imageInfo, std::string imagePath,
-             std::string imageName) {
+void processImage(ProgramArguments &args, Dyld::Context &dCtx,
+                  Provider::Accelerator<typename A::P> &accelerator,
+                  Provider::ActivityLogger &activity,
+                  std::optional<Macho::Context<false, typename A::P>> &machoCtx,
+                  std::optional<Utils::ExtractionContext<A>> &eCtx,
+                  const dyld_cache_image_info *imageInfo,
+                  std::string imagePath) {
   using P = A::P;
 
-  // Setup context
-  std::ostringstream loggerStream;
-  Provider::ActivityLogger activity("dyldex_all_multiprocess_" + imageName,
-                                    loggerStream, false);
   auto logger = activity.getLogger();
-  logger->set_pattern("[%-8l %s:%#] %v");
-  if (args.verbose) {
-    logger->set_level(spdlog::level::trace);
-  } else {
-    logger->set_level(spdlog::level::info);
-  }
-
-  auto mCtx = dCtx.createMachoCtx<false, P>(imageInfo);
+  // Kept with eCtx, which points to it
+  auto &mCtx = machoCtx.emplace(dCtx.createMachoCtx<false, P>(imageInfo));
 
   // Validate
   try {
     Provider::Validator<P>(mCtx).validate();
   } catch (const std::exception &e) {
     SPDLOG_LOGGER_ERROR(logger, "Validation Error: {}.", e.what());
-    return loggerStream;
+    return;
   }
 
   if (args.onlyValidate) {
-    return loggerStream;
+    return;
   }
 
-  Utils::ExtractionContext<A> eCtx(dCtx, mCtx, accelerator, activity);
+  // Setup context, reusing the one from the previous image if possible
+  if (eCtx) {
+    eCtx->reset(mCtx);
+  } else {
+    eCtx.emplace(dCtx, mCtx, accelerator, activity);
+  }
 
   // Process image
   if (!args.modulesDisabled.processSlideInfo) {
-    Converter::processSlideInfo(eCtx);
+    Converter::processSlideInfo(*eCtx);
   }
   if (!args.modulesDisabled.optimizeLinkedit) {
-    Converter::optimizeLinkedit(eCtx);
+    Converter::optimizeLinkedit(*eCtx);
   }
   if (!args.modulesDisabled.fixStubs) {
-    Converter::fixStubs(eCtx);
+    Converter::fixStubs(*eCtx);
   }
   if (!args.modulesDisabled.fixObjc) {
-    Converter::fixObjc(eCtx);
+    Converter::fixObjc(*eCtx);
   }
   if (!args.modulesDisabled.generateMetadata) {
-    Converter::generateMetadata(eCtx);
+    Converter::generateMetadata(*eCtx);
   }
   if (args.imbedVersion) {
     if constexpr (!std::is_same_v<P, Utils::Arch::Pointer64>) {
@@ -508,7 +505,7 @@ processImage(ProgramArguments &args, Dyld::Context &dCtx,
   }
 
   if (!args.disableOutput) {
-    auto writeProcedures = Converter::optimizeOffsets(eCtx);
+    auto writeProcedures = Converter::optimizeOffsets(*eCtx);
 
     auto outputPath = *args.outputDir / imagePath.substr(1); // remove leading /
     fs::create_directories(outputPath.parent_path());
@@ -523,8 +520,6 @@ processImage(ProgramArguments &args, Dyld::Context &dCtx,
       SPDLOG_LOGGER_ERROR(logger, "Unable to open output file.");
     }
   }
-
-  return loggerStream;
 }
 
 template <class A> int client(ProgramArguments &args) {
@@ -539,6 +534,20 @@ template <class A> int client(ProgramArguments &args) {
   Dyld::Context dCtx(args.cachePath);
   Provider::Accelerator<P> accelerator;
 
+  // Shared by all images, logs are collected and cleared after each one
+  std::ostringstream loggerStream;
+  Provider::ActivityLogger activity("dyldex_all_multiprocess", loggerStream,
+                                    false);
+  auto logger = activity.getLogger();
+  logger->set_pattern("[%-8l %s:%#] %v");
+  if (args.verbose) {
+    logger->set_level(spdlog::level::trace);
+  } else {
+    logger->set_level(spdlog::level::info);
+  }
+  std::optional<Macho::Context<false, typename A::P>> mCtx;
+  std::optional<Utils::ExtractionContext<A>> eCtx;
+
   // tell server about first image
   if (auto i = args.clientSpec.start; i < args.clientSpec.end) {
     auto nextImageName =
@@ -551,8 +560,10 @@ template <class A> int client(ProgramArguments &args) {
        i += args.clientSpec.skip) {
     auto imageInfo = dCtx.images[i];
     auto [imagePath, imageName] = getImageName(dCtx, imageInfo);
-    auto loggerStream = processImage<A>(args, dCtx, accelerator, imageInfo,
-                                        imagePath, imageName);
+    processImage<A>(args, dCtx, accelerator, activity, mCtx, eCtx, imageInfo,
+                    imagePath);
+    auto logs = loggerStream.str();
+    loggerStream.str("");
 
     // Peek ahead
     std::string nextImageName = "";
@@ -561,8 +572,8 @@ template <class A> int client(ProgramArguments &args) {
     }
 
     // Send logs
-    sendMessage(messageQueue, {args.clientSpec.clientID, imageName,
-                               loggerStream.str(), nextImageName});
+    sendMessage(messageQueue,
+                {args.clientSpec.clientID, imageName, logs, nextImageName});
   }
 
   return 0;
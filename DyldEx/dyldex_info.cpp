@@ -1,8 +1,11 @@
 #include <Converter/Stubs/Arm64Utils.h>
 #include <Dyld/Context.h>
 #include <Provider/PointerTracker.h>
+#include <Utils/Arm64Decoder.h>
 #include <Utils/Utils.h>
 #include <argparse/argparse.hpp>
+#include <capstone/capstone.h>
+#include <chrono>
 #include <filesystem>
 #include <fmt/core.h>
 
@@ -16,6 +19,7 @@ struct ProgramArguments {
   uint64_t address;
   bool findAddress;
   bool resolveChain;
+  bool benchDecoder;
 };
 
 ProgramArguments parseArgs(int argc, char *argv[]) {
@@ -41,6 +45,12 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
       .default_value(false)
       .implicit_value(true);
 
+  program.add_argument("--bench-decoder")
+      .help("Benchmark the builtin arm64 decoder against Capstone on the "
+            "__text of the image that contains the address.")
+      .default_value(false)
+      .implicit_value(true);
+
   ProgramArguments args;
   try {
     program.parse_args(argc, argv);
@@ -49,6 +59,7 @@ ProgramArguments parseArgs(int argc, char *argv[]) {
     args.address = program.get<uint64_t>("--address");
     args.findAddress = program.get<bool>("--find-address");
     args.resolveChain = program.get<bool>("--resolve-chain");
+    args.benchDecoder = program.get<bool>("--bench-decoder");
 
   } catch (const std::runtime_error &err) {
     std::cerr << "Argument parsing error: " << err.what() << std::endl;
@@ -86,11 +97,99 @@ formatStubFormat(typename Converter::Stubs::Arm64Utils<A>::StubFormat format) {
   }
 }
 
+template <class A>
+void benchDecoder(Dyld::Context &dCtx,
+                  Provider::Accelerator<typename A::P> &accelerator,
+                  uint64_t address) {
+  const dyld_cache_image_info *image = nullptr;
+  for (auto imageInfo : dCtx.images) {
+    if (accelerator.getImageCtx(dCtx, imageInfo).containsAddr(address)) {
+      image = imageInfo;
+      break;
+    }
+  }
+  if (!image) {
+    std::cerr << fmt::format(
+                     "Unable to find an image that contains the address {:#x}",
+                     address)
+              << std::endl;
+    return;
+  }
+
+  const auto &mCtx = accelerator.getImageCtx(dCtx, image);
+  auto textSect = mCtx.getSection(SEG_TEXT, SECT_TEXT).second;
+  if (!textSect) {
+    std::cerr << "Image does not have a __text section." << std::endl;
+    return;
+  }
+
+  const auto textData = mCtx.convertAddrP(textSect->addr);
+  const auto count = (std::size_t)(textSect->size / 4);
+
+  // Capstone, one instruction at a time without details like the disassembler
+  csh handle;
+  if (cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &handle) != CS_ERR_OK) {
+    std::cerr << "Unable to open Capstone engine." << std::endl;
+    return;
+  }
+  cs_option(handle, CS_OPT_DETAIL, CS_OPT_OFF);
+  cs_insn *insn = cs_malloc(handle);
+
+  std::vector<uint8_t> capstoneValid(count);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; i++) {
+    const uint8_t *code = textData + (i * 4);
+    std::size_t size = 4;
+    uint64_t addr = textSect->addr + (i * 4);
+    capstoneValid[i] = cs_disasm_iter(handle, &code, &size, &addr, insn);
+  }
+  auto capstoneTime = std::chrono::steady_clock::now() - start;
+
+  cs_free(insn, 1);
+  cs_close(&handle);
+
+  // Builtin decoder
+  std::vector<uint8_t> decoderValid(count);
+  start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < count; i++) {
+    auto raw = *(uint32_t *)(textData + (i * 4));
+    decoderValid[i] = Utils::Arm64Decoder::decode(raw).kind !=
+                      Utils::Arm64Decoder::Kind::invalid;
+  }
+  auto decoderTime = std::chrono::steady_clock::now() - start;
+
+  // Compare
+  std::size_t missedData = 0;   // Invalid for Capstone, valid for decoder
+  std::size_t rejectedCode = 0; // Valid for Capstone, invalid for decoder
+  for (std::size_t i = 0; i < count; i++) {
+    if (!capstoneValid[i] && decoderValid[i]) {
+      missedData++;
+    } else if (capstoneValid[i] && !decoderValid[i]) {
+      rejectedCode++;
+    }
+  }
+
+  using ms = std::chrono::duration<double, std::milli>;
+  auto imagePath = (const char *)(dCtx.file + image->pathFileOffset);
+  std::cout << fmt::format("{}: {} instructions", imagePath, count)
+            << std::endl;
+  std::cout << fmt::format("Capstone: {:.3f}ms", ms(capstoneTime).count())
+            << std::endl;
+  std::cout << fmt::format("Decoder: {:.3f}ms", ms(decoderTime).count())
+            << std::endl;
+  std::cout << fmt::format("Invalid only for Capstone: {}, invalid only for "
+                           "decoder: {}",
+                           missedData, rejectedCode)
+            << std::endl;
+}
+
 template <class A> void program(Dyld::Context &dCtx, ProgramArguments &args) {
+  Provider::Accelerator<typename A::P> accelerator;
+
   if (args.findAddress) {
     bool found = false;
     for (auto imageInfo : dCtx.images) {
-      auto mCtx = dCtx.createMachoCtx<true, typename A::P>(imageInfo);
+      const auto &mCtx = accelerator.getImageCtx(dCtx, imageInfo);
       if (mCtx.containsAddr(args.address)) {
         // Find the specific segment
         for (const auto &seg : mCtx.segments) {
@@ -119,7 +218,6 @@ template <class A> void program(Dyld::Context &dCtx, ProgramArguments &args) {
 
   if (args.resolveChain) {
     if constexpr (std::is_same_v<A, Utils::Arch::arm64>) {
-      Provider::Accelerator<typename A::P> accelerator;
       Provider::PointerTracker<typename A::P> ptrTracker(dCtx);
       Converter::Stubs::Arm64Utils<A> arm64Utils(dCtx, accelerator, ptrTracker);
 
@@ -146,6 +244,16 @@ template <class A> void program(Dyld::Context &dCtx, ProgramArguments &args) {
                 << std::endl;
     }
   }
+
+  if (args.benchDecoder) {
+    if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
+                  std::is_same_v<A, Utils::Arch::arm64_32>) {
+      benchDecoder<A>(dCtx, accelerator, args.address);
+    } else {
+      std::cerr << "Not implemented for architectures other than arm64."
+                << std::endl;
+    }
+  }
 }
 
 int main(int argc, char *argv[]) {
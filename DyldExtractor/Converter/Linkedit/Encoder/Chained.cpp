@@ -128,7 +128,7 @@ void ChainedEncoder::generateMetadata() {
   // Add data to linkedit, placed in the beginning
   typename Provider::LinkeditTracker<P>::Metadata meta(
       LETrackerTag::chained, nullptr, chainInfoSize, lcPos);
-  if (!leTracker.addData(meta, chainInfo.data(), chainInfoSize).second) {
+  if (!leTracker.addData(meta, std::move(chainInfo)).second) {
     SPDLOG_LOGGER_ERROR(
         logger, "Not enough space in linkedit to insert chained fixup info.");
     return;
@@ -60,8 +60,7 @@ template <class A> bool addDyldInfo(Utils::ExtractionContext<A> &eCtx) {
   typename Provider::LinkeditTracker<P>::Metadata exportTrieMeta(
       LETrackerTag::exportTrie, nullptr, linkeditSize,
       reinterpret_cast<Macho::Loader::load_command *>(dyldInfoLc));
-  success =
-      leTracker.addData(exportTrieMeta, exportTrieData.data(), trueSize).second;
+  success = leTracker.addData(exportTrieMeta, std::move(exportTrieData)).second;
   if (!success) {
     SPDLOG_LOGGER_ERROR(logger, "Unable to add export info.");
     return false;
@@ -105,11 +104,10 @@ template <class A> void applyFixups(Utils::ExtractionContext<A> &eCtx) {
 }
 
 /// @brief Returns a copy of all pointers within segments
-template <class P, class T>
-std::map<typename P::PtrT, T>
-filterPointers(const Macho::Context<false, P> &mCtx,
-               std::map<typename P::PtrT, T> pointers) {
-  std::map<typename P::PtrT, T> filtered;
+template <class P, class MapT>
+MapT filterPointers(const Macho::Context<false, P> &mCtx,
+                    const MapT &pointers) {
+  MapT filtered;
   for (const auto &seg : mCtx.segments) {
     auto beginIt = pointers.lower_bound(seg.command->vmaddr);
     auto endIt =
@@ -215,7 +213,7 @@ void addRebaseInfo(Utils::ExtractionContext<A> &eCtx,
     typename Provider::LinkeditTracker<typename A::P>::Metadata newRebaseMeta(
         LETrackerTag::rebase, nullptr, size,
         reinterpret_cast<Macho::Loader::load_command *>(dyldInfo));
-    if (!leTracker.addData(newRebaseMeta, data.data(), size).second) {
+    if (!leTracker.addData(newRebaseMeta, std::move(data)).second) {
       SPDLOG_LOGGER_ERROR(eCtx.logger, "Unable to insert new rebase info.");
       return;
     }
@@ -256,7 +254,7 @@ void addBindInfo(Utils::ExtractionContext<A> &eCtx, std::vector<uint8_t> data) {
     typename Provider::LinkeditTracker<typename A::P>::Metadata newBindingMeta(
         LETrackerTag::binding, nullptr, size,
         reinterpret_cast<Macho::Loader::load_command *>(dyldInfo));
-    if (!leTracker.addData(newBindingMeta, data.data(), size).second) {
+    if (!leTracker.addData(newBindingMeta, std::move(data)).second) {
       SPDLOG_LOGGER_ERROR(eCtx.logger, "Unable to insert new rebase info.");
       return;
     }
@@ -29,28 +29,22 @@ template <class A> void writeSymbols(Utils::ExtractionContext<A> &eCtx) {
   auto symtab = mCtx.getFirstLC<Macho::Loader::symtab_command>();
   auto dysymtab = mCtx.getFirstLC<Macho::Loader::dysymtab_command>();
 
-  // Create string pool
-  // Get size of pool and assign indicies
+  // Create string pool, string offsets were assigned when they were added
+  // unless suffixes are merged.
   auto &strings = stTracker.getStrings();
-
-  uint32_t strSize = 0;
-  uint32_t currentI = 1; // first string is \x00
-  std::map<const std::string *, uint32_t> strIndicies;
-  for (auto it = strings.cbegin(); it != strings.cend(); it++) {
-    strIndicies[&(*it)] = currentI;
-    strSize += (uint32_t)it->size();
-    currentI += (uint32_t)it->size() + 1; // include null terminator
-  }
-
-  // add null terminator for each string, and 1 for the beginning \x00
-  strSize += (uint32_t)strings.size() + 1;
-  std::vector<uint8_t> strBuf(strSize, 0x0);
-  auto strBufData = strBuf.data();
-
-  // Copy strings
-  for (auto &[it, offset] : strIndicies) {
-    memcpy(strBufData + offset, it->c_str(), it->size());
+  std::vector<uint8_t> strBuf;
+  std::vector<uint32_t> mergedOffsets;
+  if (eCtx.options.mergeStrings) {
+    std::tie(strBuf, mergedOffsets) =
+        strings.mergeSuffixes(eCtx.options.threads);
+  } else {
+    strBuf.resize(strings.size());
+    strings.copyTo(strBuf.data());
   }
+  uint32_t strSize = (uint32_t)strBuf.size();
+  auto _strOffset = [&mergedOffsets](const auto *str) -> uint32_t {
+    return mergedOffsets.empty() ? str->offset : mergedOffsets[str->index];
+  };
 
   // Create symbol table
   auto &syms = stTracker.getSymbolCaches();
@@ -80,7 +74,7 @@ template <class A> void writeSymbols(Utils::ExtractionContext<A> &eCtx) {
   auto _writeSyms = [&](auto &syms) {
     for (auto &[strIt, sym] : syms) {
       symsBuf.push_back(sym);
-      symsBuf.back().n_un.n_strx = strIndicies[&(*strIt)];
+      symsBuf.back().n_un.n_strx = _strOffset(strIt);
     }
   };
   _writeSyms(syms.other);
@@ -101,7 +95,7 @@ template <class A> void writeSymbols(Utils::ExtractionContext<A> &eCtx) {
       LETrackerTag::stringPool, nullptr,
       Utils::align(strSize, (uint32_t)sizeof(PtrT)),
       reinterpret_cast<Macho::Loader::load_command *>(symtab));
-  if (!leTracker.addData(stringPoolMeta, strBufData, strSize).second) {
+  if (!leTracker.addData(stringPoolMeta, std::move(strBuf)).second) {
     SPDLOG_LOGGER_ERROR(logger, "Not enough space to add string pool.");
     return;
   }
@@ -158,18 +152,26 @@ void Converter::generateMetadata(Utils::ExtractionContext<A> &eCtx) {
     return;
   }
 
+  // Lay out the linkedit once, after all data is generated
+  auto &leTracker = eCtx.leTracker.value();
+  leTracker.beginDeferred();
+
   // Check if new-style encoding can be used
+  bool encoded = false;
   if constexpr (std::is_same_v<A, Utils::Arch::arm64>) {
     if (!dyldInfo) {
       Encoder::ChainedEncoder(eCtx).generateMetadata();
-      writeSymbols(eCtx);
-      eCtx.activity->update(std::nullopt, "Done");
-      return;
+      encoded = true;
     }
   }
 
-  Encoder::generateLegacyMetadata(eCtx);
+  if (!encoded) {
+    Encoder::generateLegacyMetadata(eCtx);
+  }
   writeSymbols(eCtx);
+
+  eCtx.activity->update(std::nullopt, "Writing linkedit");
+  leTracker.commit();
   eCtx.activity->update(std::nullopt, "Done");
 }
 
@@ -299,7 +299,8 @@ template <class A> void LinkeditOptimizer<A>::commitData() {
 
   eCtx.stTracker = std::move(stTracker);
   eCtx.symbolizer.emplace(*eCtx.dCtx, *eCtx.mCtx, *eCtx.accelerator, activity,
-                          logger, *eCtx.stTracker);
+                          logger, *eCtx.stTracker, eCtx.options.lazySymbols,
+                          &eCtx.arena);
 }
 
 template <class A>
@@ -307,54 +308,55 @@ std::tuple<Macho::Loader::nlist<typename A::P> *,
            Macho::Loader::nlist<typename A::P> *>
 LinkeditOptimizer<A>::findLocalSymbolEntries(
     dyld_cache_local_symbols_info *symbolsInfo) {
-  // Search local symbol entries for the macho context.
-  auto searchEntries =
-      [&]<class T>(decltype(T::dylibOffset) machoOffset) -> T * {
-    T *entriesStart =
-        (T *)((uint8_t *)symbolsInfo + symbolsInfo->entriesOffset);
-    T *entriesEnd = entriesStart + symbolsInfo->entriesCount;
-    for (auto entry = entriesStart; entry < entriesEnd; entry++) {
-      if (entry->dylibOffset == machoOffset) {
-        return entry;
+  const bool newerCache =
+      dCtx.headerContainsMember(offsetof(dyld_cache_header, symbolFileUUID));
+
+  // Index the local symbol entries once for the whole cache.
+  using LocalSymbolsEntry = Provider::Accelerator<P>::LocalSymbolsEntry;
+  auto &entries = eCtx.accelerator->localSymbolsEntries;
+  if (!entries) {
+    auto indexEntries = [&]<class T>() {
+      T *entriesStart =
+          (T *)((uint8_t *)symbolsInfo + symbolsInfo->entriesOffset);
+      T *entriesEnd = entriesStart + symbolsInfo->entriesCount;
+
+      auto &index = entries.emplace();
+      index.reserve(symbolsInfo->entriesCount);
+      for (auto entry = entriesStart; entry < entriesEnd; entry++) {
+        index.try_emplace(entry->dylibOffset,
+                          LocalSymbolsEntry{(uint32_t)entry->nlistStartIndex,
+                                            (uint32_t)entry->nlistCount});
       }
-    }
+    };
 
-    return nullptr;
-  };
+    if (newerCache) {
+      indexEntries.template operator()<dyld_cache_local_symbols_entry_64>();
+    } else {
+      indexEntries.template operator()<dyld_cache_local_symbols_entry>();
+    }
+  }
 
-  uint8_t *nlistStart = nullptr;
-  uint32_t nlistCount = 0;
-  if (dCtx.headerContainsMember(offsetof(dyld_cache_header, symbolFileUUID))) {
+  uint64_t textAddr = mCtx.getSegment(SEG_TEXT)->command->vmaddr;
+  uint64_t machoOffset;
+  if (newerCache) {
     // Newer caches, vm offset to mach header.
-    uint64_t machoOffset = mCtx.getSegment(SEG_TEXT)->command->vmaddr -
-                           dCtx.header->sharedRegionStart;
-    auto entry = searchEntries.operator()<dyld_cache_local_symbols_entry_64>(
-        machoOffset);
-    if (entry) {
-      nlistStart = (uint8_t *)symbolsInfo + symbolsInfo->nlistOffset +
-                   sizeof(Macho::Loader::nlist<P>) * entry->nlistStartIndex;
-      nlistCount = entry->nlistCount;
-    }
+    machoOffset = textAddr - dCtx.header->sharedRegionStart;
   } else {
     // Older caches, file offset to mach header.
-    uint64_t machoOffset =
-        mCtx.convertAddr(mCtx.getSegment(SEG_TEXT)->command->vmaddr).first;
-    auto entry = searchEntries.operator()<dyld_cache_local_symbols_entry>(
-        (uint32_t)machoOffset);
-    if (entry) {
-      nlistStart = (uint8_t *)symbolsInfo + symbolsInfo->nlistOffset +
-                   sizeof(Macho::Loader::nlist<P>) * entry->nlistStartIndex;
-      nlistCount = entry->nlistCount;
-    }
+    machoOffset = (uint32_t)mCtx.convertAddr(textAddr).first;
   }
 
-  if (!nlistStart) {
+  auto entryIt = entries->find(machoOffset);
+  if (entryIt == entries->end()) {
     SPDLOG_LOGGER_ERROR(logger, "Unable to find local symbol entries.");
     return std::make_tuple(nullptr, nullptr);
   }
 
-  return std::make_tuple((Macho::Loader::nlist<P> *)nlistStart,
-                         (Macho::Loader::nlist<P> *)nlistStart + nlistCount);
+  auto nlistStart =
+      (Macho::Loader::nlist<P> *)((uint8_t *)symbolsInfo +
+                                  symbolsInfo->nlistOffset) +
+      entryIt->second.nlistStartIndex;
+  return std::make_tuple(nlistStart, nlistStart + entryIt->second.nlistCount);
 }
 
 template <class A> void LinkeditOptimizer<A>::copyPublicLocalSymbols() {
@@ -395,12 +397,15 @@ template <class A> void LinkeditOptimizer<A>::copyRedactedLocalSymbols() {
     SPDLOG_LOGGER_ERROR(logger, "Unable to copy redacted local symbols.");
   }
 
+  // The symbols cache is not modified, so names are referenced in place and
+  // only copied when the string pool is written.
   auto stringsStart = (uint8_t *)localSymsInfo + localSymsInfo->stringsOffset;
+  stTracker.reserveSyms(STSymbolType::local, symsEnd - symsStart);
   for (auto symEntry = symsStart; symEntry < symsEnd; symEntry++) {
     const char *string = (const char *)stringsStart + symEntry->n_un.n_strx;
 
     // Local symbol indices are not tracked for indirect symbols
-    auto &str = stTracker.addString(string);
+    auto &str = stTracker.addExternalString(string);
     stTracker.addSym(STSymbolType::local, str, *symEntry);
 
     activity.update();
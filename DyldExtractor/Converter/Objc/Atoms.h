@@ -18,11 +18,16 @@ template <class P> class AtomBase {
   using PtrT = P::PtrT;
 
 public:
-  /// @brief Get all child atoms.
-  /// @return A vector of pairs of the atom pointers and their relative offsets
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>> getAtoms() const {
-    return std::vector<std::pair<AtomBase<P> *, PtrT>>();
-  }
+  /// @brief Receives child atoms from visitAtoms.
+  class Visitor {
+  public:
+    /// @param atom The child atom
+    /// @param offset The offset of the child, relative to the parent
+    virtual void operator()(AtomBase<P> &atom, PtrT offset) = 0;
+  };
+
+  /// @brief Visit all child atoms, without allocating.
+  virtual void visitAtoms(Visitor &visit) {}
 
   /// @brief Gets the encoded size of the entire atom, including children
   virtual PtrT encodedSize() const { return 0; }
@@ -30,9 +35,12 @@ public:
   /// @brief Propagate any relationships to the data structure
   /// @details Must be called after finalAddr for dependencies are set.
   virtual void propagate() {
-    for (auto &[atom, offset] : getAtoms()) {
-      atom->propagate();
-    }
+    struct : Visitor {
+      void operator()(AtomBase<P> &atom, PtrT offset) override {
+        atom.propagate();
+      }
+    } visitor;
+    visitAtoms(visitor);
   }
 
   /// @brief Gets the finalAddr, must be set first
@@ -43,9 +51,14 @@ public:
     assert(!_finalAddr && "Final address was already set.");
     _finalAddr = addr;
 
-    for (auto &[atom, offset] : getAtoms()) {
-      atom->setFinalAddr(addr + offset);
-    }
+    struct : Visitor {
+      PtrT addr;
+      void operator()(AtomBase<P> &atom, PtrT offset) override {
+        atom.setFinalAddr(addr + offset);
+      }
+    } visitor;
+    visitor.addr = addr;
+    visitAtoms(visitor);
   }
 
   /// @brief If the final placement is in the image
@@ -211,6 +224,10 @@ public:
   virtual PtrT encodedSize() const override {
     return (PtrT)strlen(this->data) + 1; // include null terminator
   }
+
+  /// @brief If it shares the placement of another string with the same
+  ///   content, and doesn't need to be written.
+  bool deduplicated = false;
 };
 
 /// @brief Represents a null terminated bitmap
@@ -247,11 +264,10 @@ public:
       : Atom<P, DataT>(data), name(&this->data.name), types(&this->data.types),
         imp(&this->data.imp) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-            {(AtomBase<P> *)&types, (PtrT)offsetof(DataT, types)},
-            {(AtomBase<P> *)&imp, (PtrT)offsetof(DataT, imp)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(types, (PtrT)offsetof(DataT, types));
+    visit(imp, (PtrT)offsetof(DataT, imp));
   }
 
   RelativeRefAtom<P, PointerAtom<P, StringAtom<P>>> name;
@@ -270,11 +286,10 @@ public:
       : Atom<P, DataT>(data), name(&this->data.name), types(&this->data.types),
         imp(&this->data.imp) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-            {(AtomBase<P> *)&types, (PtrT)offsetof(DataT, types)},
-            {(AtomBase<P> *)&imp, (PtrT)offsetof(DataT, imp)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(types, (PtrT)offsetof(DataT, types));
+    visit(imp, (PtrT)offsetof(DataT, imp));
   }
 
   FieldRefAtom<P, StringAtom<P>> name;
@@ -298,18 +313,12 @@ template <class P> class SmallMethodListAtom final : public MethodListAtom<P> {
 
 public:
   using MethodListAtom<P>::MethodListAtom;
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
-
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = sizeof(DataT);
     for (auto &method : entries) {
-      atoms.emplace_back((AtomBase<P> *)&method, offset);
+      visit(method, offset);
       offset += this->data.getEntsize();
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
@@ -328,18 +337,12 @@ template <class P> class LargeMethodListAtom final : public MethodListAtom<P> {
 
 public:
   using MethodListAtom<P>::MethodListAtom;
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
-
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = sizeof(DataT);
     for (auto &method : entries) {
-      atoms.emplace_back((AtomBase<P> *)&method, offset);
+      visit(method, offset);
       offset += this->data.getEntsize();
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
@@ -359,10 +362,9 @@ public:
       : Atom<P, DataT>(data), name(&this->data.name),
         attributes(&this->data.attributes) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-            {(AtomBase<P> *)&attributes, (PtrT)offsetof(DataT, attributes)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(attributes, (PtrT)offsetof(DataT, attributes));
   }
 
   FieldRefAtom<P, StringAtom<P>> name;
@@ -376,18 +378,12 @@ class PropertyListAtom final : public Atom<P, Objc::property_list_t> {
 
 public:
   using Atom<P, DataT>::Atom;
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
-
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = sizeof(DataT);
     for (auto &property : entries) {
-      atoms.emplace_back((AtomBase<P> *)&property, offset);
+      visit(property, offset);
       offset += this->data.entsize;
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
@@ -402,26 +398,23 @@ class ExtendedMethodTypesAtom final : public Atom<P, typename P::PtrT> {
   using PtrT = P::PtrT;
 
 public:
-  ExtendedMethodTypesAtom() : Atom<P, typename P::PtrT>(0) {}
-
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
+  explicit ExtendedMethodTypesAtom(uint32_t count)
+      : Atom<P, typename P::PtrT>(0), count(count) {}
 
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = 0;
     for (auto &type : entries) {
-      atoms.emplace_back((AtomBase<P> *)&type, offset);
+      visit(type, offset);
       offset += sizeof(PtrT);
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
     return (PtrT)(sizeof(PtrT) * entries.size());
   }
 
+  /// @brief The number of entries it was walked with
+  const uint32_t count;
   std::list<PointerAtom<P, StringAtom<P>>> entries;
 };
 
@@ -446,26 +439,19 @@ public:
         demangledName(&this->data.demangledName),
         classProperties(&this->data.classProperties) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {
-        {(AtomBase<P> *)&isa, (PtrT)offsetof(DataT, isa)},
-        {(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-        {(AtomBase<P> *)&protocols, (PtrT)offsetof(DataT, protocols)},
-        {(AtomBase<P> *)&instanceMethods,
-         (PtrT)offsetof(DataT, instanceMethods)},
-        {(AtomBase<P> *)&classMethods, (PtrT)offsetof(DataT, classMethods)},
-        {(AtomBase<P> *)&optionalInstanceMethods,
-         (PtrT)offsetof(DataT, optionalInstanceMethods)},
-        {(AtomBase<P> *)&optionalClassMethods,
-         (PtrT)offsetof(DataT, optionalClassMethods)},
-        {(AtomBase<P> *)&instanceProperties,
-         (PtrT)offsetof(DataT, instanceProperties)},
-        {(AtomBase<P> *)&extendedMethodTypes,
-         (PtrT)offsetof(DataT, extendedMethodTypes)},
-        {(AtomBase<P> *)&demangledName, (PtrT)offsetof(DataT, demangledName)},
-        {(AtomBase<P> *)&classProperties,
-         (PtrT)offsetof(DataT, classProperties)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(isa, (PtrT)offsetof(DataT, isa));
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(protocols, (PtrT)offsetof(DataT, protocols));
+    visit(instanceMethods, (PtrT)offsetof(DataT, instanceMethods));
+    visit(classMethods, (PtrT)offsetof(DataT, classMethods));
+    visit(optionalInstanceMethods,
+          (PtrT)offsetof(DataT, optionalInstanceMethods));
+    visit(optionalClassMethods, (PtrT)offsetof(DataT, optionalClassMethods));
+    visit(instanceProperties, (PtrT)offsetof(DataT, instanceProperties));
+    visit(extendedMethodTypes, (PtrT)offsetof(DataT, extendedMethodTypes));
+    visit(demangledName, (PtrT)offsetof(DataT, demangledName));
+    visit(classProperties, (PtrT)offsetof(DataT, classProperties));
   }
 
   virtual PtrT encodedSize() const override { return this->data.size; }
@@ -494,18 +480,12 @@ class ProtocolListAtom final
 
 public:
   using Atom<P, DataT>::Atom;
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
-
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = sizeof(DataT);
     for (auto &protocol : entries) {
-      atoms.emplace_back((AtomBase<P> *)&protocol, offset);
+      visit(protocol, offset);
       offset += sizeof(PtrT);
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
@@ -528,11 +508,10 @@ public:
       : Atom<P, DataT>(data), offset(&this->data.offset),
         name(&this->data.name), type(&this->data.type) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&offset, (PtrT)offsetof(DataT, offset)},
-            {(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-            {(AtomBase<P> *)&type, (PtrT)offsetof(DataT, type)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(offset, (PtrT)offsetof(DataT, offset));
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(type, (PtrT)offsetof(DataT, type));
   }
 
   FieldRefAtom<P, IvarOffsetAtom<A>> offset;
@@ -549,18 +528,12 @@ class IvarListAtom final : public Atom<typename A::P, Objc::ivar_list_t> {
 
 public:
   using Atom<P, DataT>::Atom;
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    std::vector<std::pair<AtomBase<P> *, PtrT>> atoms;
-    atoms.reserve(entries.size());
-
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
     PtrT offset = sizeof(DataT);
     for (auto &ivar : entries) {
-      atoms.emplace_back((AtomBase<P> *)&ivar, offset);
+      visit(ivar, offset);
       offset += this->data.entsize;
     }
-
-    return atoms;
   }
 
   virtual PtrT encodedSize() const override {
@@ -586,17 +559,14 @@ public:
         weakIvarLayout(&this->data.weakIvarLayout),
         baseProperties(&this->data.baseProperties) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {
-        {(AtomBase<P> *)&ivarLayout, (PtrT)offsetof(DataT, ivarLayout)},
-        {(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-        {(AtomBase<P> *)&baseMethods, (PtrT)offsetof(DataT, baseMethods)},
-        {(AtomBase<P> *)&baseProtocols, (PtrT)offsetof(DataT, baseProtocols)},
-        {(AtomBase<P> *)&ivars, (PtrT)offsetof(DataT, ivars)},
-        {(AtomBase<P> *)&weakIvarLayout, (PtrT)offsetof(DataT, weakIvarLayout)},
-        {(AtomBase<P> *)&baseProperties,
-         (PtrT)offsetof(DataT, baseProperties)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(ivarLayout, (PtrT)offsetof(DataT, ivarLayout));
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(baseMethods, (PtrT)offsetof(DataT, baseMethods));
+    visit(baseProtocols, (PtrT)offsetof(DataT, baseProtocols));
+    visit(ivars, (PtrT)offsetof(DataT, ivars));
+    visit(weakIvarLayout, (PtrT)offsetof(DataT, weakIvarLayout));
+    visit(baseProperties, (PtrT)offsetof(DataT, baseProperties));
   }
 
   FieldRefAtom<P, IvarLayoutAtom<P>> ivarLayout;
@@ -621,11 +591,10 @@ public:
       : Atom<P, DataT>(data), isa(&this->data.isa),
         superclass(&this->data.superclass), classData(&this->data.data) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&isa, (PtrT)offsetof(DataT, isa)},
-            {(AtomBase<P> *)&superclass, (PtrT)offsetof(DataT, superclass)},
-            {(AtomBase<P> *)&classData, (PtrT)offsetof(DataT, data)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(isa, (PtrT)offsetof(DataT, isa));
+    visit(superclass, (PtrT)offsetof(DataT, superclass));
+    visit(classData, (PtrT)offsetof(DataT, data));
   }
 
   virtual void propagate() override {
@@ -658,18 +627,14 @@ public:
         instanceProperties(&this->data.instanceProperties),
         _classProperties(&this->data._classProperties) {}
 
-  virtual std::vector<std::pair<AtomBase<P> *, PtrT>>
-  getAtoms() const override {
-    return {{(AtomBase<P> *)&name, (PtrT)offsetof(DataT, name)},
-            {(AtomBase<P> *)&cls, (PtrT)offsetof(DataT, cls)},
-            {(AtomBase<P> *)&instanceMethods,
-             (PtrT)offsetof(DataT, instanceMethods)},
-            {(AtomBase<P> *)&classMethods, (PtrT)offsetof(DataT, classMethods)},
-            {(AtomBase<P> *)&protocols, (PtrT)offsetof(DataT, protocols)},
-            {(AtomBase<P> *)&instanceProperties,
-             (PtrT)offsetof(DataT, instanceProperties)},
-            {(AtomBase<P> *)&_classProperties,
-             (PtrT)offsetof(DataT, _classProperties)}};
+  virtual void visitAtoms(typename AtomBase<P>::Visitor &visit) override {
+    visit(name, (PtrT)offsetof(DataT, name));
+    visit(cls, (PtrT)offsetof(DataT, cls));
+    visit(instanceMethods, (PtrT)offsetof(DataT, instanceMethods));
+    visit(classMethods, (PtrT)offsetof(DataT, classMethods));
+    visit(protocols, (PtrT)offsetof(DataT, protocols));
+    visit(instanceProperties, (PtrT)offsetof(DataT, instanceProperties));
+    visit(_classProperties, (PtrT)offsetof(DataT, _classProperties));
   }
 
   virtual PtrT encodedSize() const override {
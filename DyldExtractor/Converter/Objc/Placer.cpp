@@ -1,6 +1,8 @@
 #include "Placer.h"
 
 #include "../OffsetOptimizer.h"
+#include <string_view>
+#include <unordered_map>
 
 using namespace DyldExtractor;
 using namespace Converter;
@@ -23,9 +25,7 @@ std::optional<Provider::ExtraData<typename A::P>> Placer<A>::placeAll() {
   PtrT exDataSize = placeAtoms(exDataAddr);
   Provider::ExtraData<P> exData(extendsSeg, exDataAddr, exDataSize);
 
-  propagateAtoms();
-  writeAtoms(exData);
-  trackAtoms(exData);
+  emitAtoms(exData);
   return exData;
 }
 
@@ -146,249 +146,173 @@ Placer<A>::PtrT Placer<A>::placeAtoms(const PtrT exDataAddr) {
   placeAtoms(walker.atoms.categories);
   placeAtoms(walker.atoms.smallMethodSelRefs, true, true);
 
-  placeAtoms(walker.atoms.strings, false);
+  placeStrings(currentAddr);
   placeAtoms(walker.atoms.ivarLayouts, false);
   placeAtoms(walker.atoms.ivarOffsets, false);
 
   return currentAddr - exDataAddr;
 }
 
-template <class A> void Placer<A>::propagateAtoms() {
-  auto propagateAtoms = [](auto &atoms) {
-    for (auto &[origAddr, atom] : atoms) {
-      atom.propagate();
+template <class A> void Placer<A>::placeStrings(PtrT &currentAddr) {
+  // Strings in the image keep their place, and can be shared by others
+  std::unordered_map<std::string_view, PtrT> placed;
+  for (auto &[origAddr, atom] : walker.atoms.strings) {
+    if (mCtx.containsAddr(origAddr)) {
+      atom.setFinalAddr(origAddr);
+      atom.placedInImage = true;
+      placed.try_emplace(atom.data, origAddr);
     }
-  };
+  }
 
-  propagateAtoms(walker.atoms.classes);
-  propagateAtoms(walker.atoms.classData);
-  propagateAtoms(walker.atoms.smallMethodLists);
-  propagateAtoms(walker.atoms.largeMethodLists);
-  propagateAtoms(walker.atoms.protocolLists);
-  propagateAtoms(walker.atoms.propertyLists);
-  propagateAtoms(walker.atoms.ivarLists);
-  propagateAtoms(walker.atoms.extendedMethodTypes);
-  propagateAtoms(walker.atoms.protocols);
-  propagateAtoms(walker.atoms.categories);
-  propagateAtoms(walker.atoms.smallMethodSelRefs);
-  propagateAtoms(walker.atoms.strings);
-  propagateAtoms(walker.atoms.ivarLayouts);
-  propagateAtoms(walker.atoms.ivarOffsets);
-
-  propagateAtoms(walker.pointers.classes);
-  propagateAtoms(walker.pointers.categories);
-  propagateAtoms(walker.pointers.protocols);
-  propagateAtoms(walker.pointers.selectorRefs);
-  propagateAtoms(walker.pointers.protocolRefs);
-  propagateAtoms(walker.pointers.classRefs);
-  propagateAtoms(walker.pointers.superRefs);
+  for (auto &[origAddr, atom] : walker.atoms.strings) {
+    if (atom.placedInImage) {
+      continue;
+    }
+
+    const std::string_view str(atom.data);
+    if (auto it = placed.find(str); it != placed.end()) {
+      atom.setFinalAddr(it->second);
+      atom.deduplicated = true;
+    } else {
+      atom.setFinalAddr(currentAddr);
+      placed.emplace(str, currentAddr);
+      currentAddr += (PtrT)str.size() + 1; // include null terminator
+    }
+  }
+
+  Utils::align(&currentAddr, sizeof(PtrT));
 }
 
-template <class A> void Placer<A>::writeAtoms(Provider::ExtraData<P> &exData) {
+template <class A> void Placer<A>::emitAtoms(Provider::ExtraData<P> &exData) {
   auto exDataLoc = exData.getData();
   auto exDataStart = exData.getBaseAddr();
   auto exDataEnd = exData.getEndAddr();
 
-  // Write simple atoms
-  auto writeAtoms = [&](auto &atoms) {
-    for (auto &[origAddr, atom] : atoms) {
-      auto finalAddr = atom.finalAddr();
-      uint8_t *atomLoc;
-      if (finalAddr >= exDataStart && finalAddr < exDataEnd) {
-        atomLoc = exDataLoc + (finalAddr - exDataStart);
-      } else {
-        atomLoc = mCtx.convertAddrP(finalAddr);
-      }
+  // All addresses are final, so each atom can be propagated, written, and
+  // tracked in one visit. Tracking is merged into the tracker at the end.
+  typename Provider::PointerTracker<P>::Batch batch;
 
-      memcpy(atomLoc, (uint8_t *)&atom.data, atom.encodedSize());
+  auto atomLoc = [&](auto &atom) {
+    auto finalAddr = atom.finalAddr();
+    if (atom.placedInImage) {
+      return mCtx.convertAddrP(finalAddr);
+    } else {
+      assert(finalAddr >= exDataStart && finalAddr < exDataEnd);
+      return exDataLoc + (finalAddr - exDataStart);
     }
   };
 
-  // Write an atom with a list after it
-  auto writeAtomLists = [&](auto &atoms, PtrT headerSize) {
-    for (auto &[origAddr, atom] : atoms) {
-      auto finalAddr = atom.finalAddr();
-
-      uint8_t *atomLoc;
-      if (atom.placedInImage) {
-        atomLoc = mCtx.convertAddrP(finalAddr);
-      } else {
-        assert(finalAddr >= exDataStart && finalAddr < exDataEnd);
-        atomLoc = exDataLoc + (finalAddr - exDataStart);
-      }
-
-      // Write header atom
-      memcpy(atomLoc, (uint8_t *)&atom.data, headerSize);
-
-      // Write entries
-      for (auto &entry : atom.entries) {
-        auto entryFinalAddr = entry.finalAddr();
-
-        auto entryLoc = atomLoc + (entryFinalAddr - finalAddr);
-        memcpy(entryLoc, (uint8_t *)&entry.data, entry.encodedSize());
-      }
+  auto addBind = [&](auto &ref) {
+    if (ref.bind) {
+      batch.addBind(ref.finalAddr(), ref.bind);
+      checkBind(ref.bind);
     }
   };
 
-  writeAtoms(walker.atoms.classes);
-  writeAtoms(walker.atoms.classData);
-
-  writeAtomLists(walker.atoms.smallMethodLists, sizeof(Objc::method_list_t));
-  writeAtomLists(walker.atoms.largeMethodLists, sizeof(Objc::method_list_t));
-  writeAtomLists(walker.atoms.protocolLists, sizeof(Objc::protocol_list_t<P>));
-  writeAtomLists(walker.atoms.propertyLists, sizeof(Objc::property_list_t));
-  writeAtomLists(walker.atoms.ivarLists, sizeof(Objc::ivar_list_t));
-  writeAtomLists(walker.atoms.extendedMethodTypes, 0);
-
-  writeAtoms(walker.atoms.protocols);
-  writeAtoms(walker.atoms.categories);
-  writeAtoms(walker.atoms.smallMethodSelRefs);
-  writeAtoms(walker.atoms.ivarOffsets);
-
-  for (auto &[origAddr, atom] : walker.atoms.strings) {
-    if (!atom.placedInImage) {
-      auto finalAddr = atom.finalAddr();
-      assert(finalAddr >= exDataStart && finalAddr < exDataEnd);
-      uint8_t *atomLoc = exDataLoc + (finalAddr - exDataStart);
-      memcpy(atomLoc, atom.data, atom.encodedSize());
-    }
-  }
-
-  for (auto &[origAddr, atom] : walker.atoms.ivarLayouts) {
-    if (!atom.placedInImage) {
-      auto finalAddr = atom.finalAddr();
-      assert(finalAddr >= exDataStart && finalAddr < exDataEnd);
-      uint8_t *atomLoc = exDataLoc + (finalAddr - exDataStart);
-      memcpy(atomLoc, atom.data, atom.encodedSize());
-    }
-  }
-}
-
-template <class A> void Placer<A>::trackAtoms(Provider::ExtraData<P> &exData) {
-  // evict all tracked pointers in extra data region
-  ptrTracker.removePointers(exData.getBaseAddr(), exData.getEndAddr());
-
-  /// @brief tracks pointers in an atom, must be an objc struct
-  auto trackAtoms = [&](auto &atoms) {
+  /// @brief Emits atoms, must be objc structs
+  auto emitAtoms = [&](auto &atoms, auto &&emitBinds) {
     for (auto &[origAddr, atom] : atoms) {
+      atom.propagate();
+
       auto finalAddr = atom.finalAddr();
-      ptrTracker.addS(finalAddr, atom.data);
-      ptrTracker.copyAuthS<decltype(atom.data)>(finalAddr, origAddr);
+      memcpy(atomLoc(atom), (uint8_t *)&atom.data, atom.encodedSize());
+      batch.addS(finalAddr, atom.data);
+      ptrTracker.copyAuthS<decltype(atom.data)>(finalAddr, origAddr, batch);
+      emitBinds(atom);
     }
   };
+  auto noBinds = [](auto &atom) {};
 
-  /// @brief tracks pointers in an atom list, header and entry must be objc
-  ///   structs
-  auto trackPointerLists = [&](auto &atoms) {
+  /// @brief Emits atoms with a list after it, headers don't have pointers and
+  ///   entries must be objc structs or pointers
+  auto emitAtomLists = [&](auto &atoms, PtrT headerSize) {
     for (auto &[origAddr, atom] : atoms) {
+      atom.propagate();
+
       auto finalAddr = atom.finalAddr();
-      ptrTracker.addS(finalAddr, atom.data);
-      ptrTracker.copyAuthS<decltype(atom.data)>(finalAddr, origAddr);
+      auto loc = atomLoc(atom);
+      memcpy(loc, (uint8_t *)&atom.data, headerSize);
 
       for (auto &entry : atom.entries) {
         auto entryFinalAddr = entry.finalAddr();
         PtrT entryOrigAddr = origAddr + entryFinalAddr - finalAddr;
-        ptrTracker.addS(entryFinalAddr, entry.data);
-        ptrTracker.copyAuthS<decltype(atom.data)>(entryFinalAddr,
-                                                  entryOrigAddr);
+        memcpy(loc + (entryFinalAddr - finalAddr), (uint8_t *)&entry.data,
+               entry.encodedSize());
+
+        using EntryT = decltype(entry.data);
+        if constexpr (std::is_same_v<EntryT, PtrT>) {
+          batch.add(entryFinalAddr, entry.data);
+          ptrTracker.copyAuth(entryFinalAddr, entryOrigAddr, batch);
+        } else {
+          batch.addS(entryFinalAddr, entry.data);
+          ptrTracker.copyAuthS<EntryT>(entryFinalAddr, entryOrigAddr, batch);
+        }
       }
     }
   };
 
-  trackAtoms(walker.atoms.classes);
-  trackAtoms(walker.atoms.classData);
-  trackAtoms(walker.atoms.protocols);
-  trackAtoms(walker.atoms.categories);
-
-  trackPointerLists(walker.atoms.smallMethodLists);
-  trackPointerLists(walker.atoms.largeMethodLists);
-  trackPointerLists(walker.atoms.propertyLists);
-  trackPointerLists(walker.atoms.ivarLists);
-
-  for (auto &[origAddr, atom] : walker.atoms.smallMethodSelRefs) {
-    auto finalAddr = atom.finalAddr();
-    ptrTracker.add(finalAddr, atom.data);
-    ptrTracker.copyAuth(finalAddr, origAddr);
-  }
-
-  for (auto &[origAddr, atom] : walker.atoms.protocolLists) {
-    auto finalAddr = atom.finalAddr();
-
-    for (auto &entry : atom.entries) {
-      auto entryFinalAddr = entry.finalAddr();
-      PtrT entryOrigAddr = origAddr + entryFinalAddr - finalAddr;
-      ptrTracker.add(entryFinalAddr, entry.data);
-      ptrTracker.copyAuth(entryFinalAddr, entryOrigAddr);
-    }
-  }
-
-  for (auto &[origAddr, atom] : walker.atoms.extendedMethodTypes) {
-    auto finalAddr = atom.finalAddr();
-
-    for (auto &entry : atom.entries) {
-      auto entryFinalAddr = entry.finalAddr();
-      PtrT entryOrigAddr = origAddr + entryFinalAddr - finalAddr;
-      ptrTracker.add(entryFinalAddr, entry.data);
-      ptrTracker.copyAuth(entryFinalAddr, entryOrigAddr);
-    }
-  }
-
-  // Add in-image pointers
-  auto trackPointers = [&](auto &atoms) {
+  /// @brief Emits pointers in the image
+  auto emitPointers = [&](auto &atoms, auto &&emitBinds) {
     for (auto &[pAddr, pAtom] : atoms) {
-      ptrTracker.add(pAddr, pAtom.data);
+      pAtom.propagate();
+      batch.add(pAddr, pAtom.data);
+      emitBinds(pAtom);
     }
   };
 
-  trackPointers(walker.pointers.classes);
-  trackPointers(walker.pointers.categories);
-  trackPointers(walker.pointers.protocols);
-  trackPointers(walker.pointers.selectorRefs);
-  trackPointers(walker.pointers.protocolRefs);
+  emitAtoms(walker.atoms.classes, [&](auto &atom) {
+    addBind(atom.isa);
+    addBind(atom.superclass);
+  });
+  emitAtoms(walker.atoms.classData, noBinds);
 
-  for (auto &[pAddr, pAtom] : walker.pointers.classRefs) {
-    ptrTracker.add(pAddr, pAtom.data);
+  emitAtomLists(walker.atoms.smallMethodLists, sizeof(Objc::method_list_t));
+  emitAtomLists(walker.atoms.largeMethodLists, sizeof(Objc::method_list_t));
+  emitAtomLists(walker.atoms.protocolLists, sizeof(Objc::protocol_list_t<P>));
+  emitAtomLists(walker.atoms.propertyLists, sizeof(Objc::property_list_t));
+  emitAtomLists(walker.atoms.ivarLists, sizeof(Objc::ivar_list_t));
+  emitAtomLists(walker.atoms.extendedMethodTypes, 0);
 
-    if (pAtom.bind) {
-      ptrTracker.addBind(pAddr, pAtom.bind);
-      checkBind(pAtom.bind);
-    }
-  }
+  emitAtoms(walker.atoms.protocols,
+            [&](auto &atom) { addBind(atom.isa); });
+  emitAtoms(walker.atoms.categories,
+            [&](auto &atom) { addBind(atom.cls); });
 
-  for (auto &[pAddr, pAtom] : walker.pointers.superRefs) {
-    ptrTracker.add(pAddr, pAtom.data);
+  for (auto &[origAddr, atom] : walker.atoms.smallMethodSelRefs) {
+    atom.propagate();
 
-    if (pAtom.bind) {
-      ptrTracker.addBind(pAddr, pAtom.bind);
-      checkBind(pAtom.bind);
-    }
+    auto finalAddr = atom.finalAddr();
+    memcpy(atomLoc(atom), (uint8_t *)&atom.data, atom.encodedSize());
+    batch.add(finalAddr, atom.data);
+    ptrTracker.copyAuth(finalAddr, origAddr, batch);
   }
 
-  // Add binds for structures
-  for (auto &[origAddr, atom] : walker.atoms.classes) {
-    if (atom.isa.bind) {
-      ptrTracker.addBind(atom.isa.finalAddr(), atom.isa.bind);
-      checkBind(atom.isa.bind);
-    }
-    if (atom.superclass.bind) {
-      ptrTracker.addBind(atom.superclass.finalAddr(), atom.superclass.bind);
-      checkBind(atom.superclass.bind);
-    }
+  for (auto &[origAddr, atom] : walker.atoms.ivarOffsets) {
+    memcpy(atomLoc(atom), (uint8_t *)&atom.data, atom.encodedSize());
   }
 
-  for (auto &[origAddr, atom] : walker.atoms.protocols) {
-    if (atom.isa.bind) {
-      ptrTracker.addBind(atom.isa.finalAddr(), atom.isa.bind);
-      checkBind(atom.isa.bind);
+  for (auto &[origAddr, atom] : walker.atoms.strings) {
+    if (!atom.placedInImage && !atom.deduplicated) {
+      memcpy(atomLoc(atom), atom.data, atom.encodedSize());
     }
   }
-
-  for (auto &[origAddr, atom] : walker.atoms.categories) {
-    if (atom.cls.bind) {
-      ptrTracker.addBind(atom.cls.finalAddr(), atom.cls.bind);
-      checkBind(atom.cls.bind);
+  for (auto &[origAddr, atom] : walker.atoms.ivarLayouts) {
+    if (!atom.placedInImage) {
+      memcpy(atomLoc(atom), atom.data, atom.encodedSize());
     }
   }
+
+  emitPointers(walker.pointers.classes, noBinds);
+  emitPointers(walker.pointers.categories, noBinds);
+  emitPointers(walker.pointers.protocols, noBinds);
+  emitPointers(walker.pointers.selectorRefs, noBinds);
+  emitPointers(walker.pointers.protocolRefs, noBinds);
+  emitPointers(walker.pointers.classRefs, addBind);
+  emitPointers(walker.pointers.superRefs, addBind);
+
+  // Replace all tracked pointers in extra data region
+  ptrTracker.removePointers(exDataStart, exDataEnd);
+  ptrTracker.merge(batch);
 }
 
 template <class A>
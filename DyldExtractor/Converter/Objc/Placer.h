@@ -23,12 +23,12 @@ private:
   /// @brief Gives addresses to all atoms
   /// @returns The size of the extra data section
   PtrT placeAtoms(const PtrT exDataAddr);
-  /// @brief Propagate all atoms
-  void propagateAtoms();
-  /// @brief Update data fields and write
-  void writeAtoms(Provider::ExtraData<P> &exData);
-  /// @brief Adds pointers to tracking
-  void trackAtoms(Provider::ExtraData<P> &exData);
+  /// @brief Gives addresses to strings, strings with the same content are
+  ///   placed once.
+  /// @param currentAddr The next free address in the extra data, updated.
+  void placeStrings(PtrT &currentAddr);
+  /// @brief Propagate, write, and add pointers to tracking, for all atoms
+  void emitAtoms(Provider::ExtraData<P> &exData);
 
   /// @brief Checks if a bind has a symbol entry
   void checkBind(const std::shared_ptr<Provider::SymbolicInfo> &bind);
@@ -1,14 +1,17 @@
 #include "Walker.h"
 
+#include <Utils/Threading.h>
+
 using namespace DyldExtractor;
 using namespace Converter;
 using namespace ObjcFixer;
 
 template <class A>
 Walker<A>::Walker(Utils::ExtractionContext<A> &eCtx)
-    : dCtx(*eCtx.dCtx), mCtx(*eCtx.mCtx), activity(*eCtx.activity),
-      logger(eCtx.logger), bindInfo(eCtx.bindInfo), ptrTracker(eCtx.ptrTracker),
-      symbolizer(eCtx.symbolizer.value()) {}
+    : dCtx(*eCtx.dCtx), mCtx(*eCtx.mCtx), accelerator(*eCtx.accelerator),
+      activity(*eCtx.activity), logger(eCtx.logger), bindInfo(eCtx.bindInfo),
+      ptrTracker(eCtx.ptrTracker), symbolizer(eCtx.symbolizer.value()),
+      threads(eCtx.options.threads) {}
 
 template <class A> bool Walker<A>::walkAll() {
   if (auto sect = mCtx.getSection(nullptr, "__objc_imageinfo").second; sect) {
@@ -34,14 +37,13 @@ template <class A> bool Walker<A>::walkAll() {
     bindRecords[(PtrT)bind.address] = &bind;
   }
 
-  mCtx.enumerateSections([this, &bindRecords](const auto seg, const auto sect) {
+  mCtx.enumerateSections([this, &bindRecords](auto &seg, const auto sect) {
     PtrT sectAddr = sect->addr;
     PtrT sectEnd = sectAddr + sect->size;
 
     if (memcmp(sect->sectname, "__objc_classlist", 16) == 0) {
       activity.update(std::nullopt, "Processing classes");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto cAddr = ptrTracker.slideP(pAddr);
 
         if (mCtx.containsAddr(cAddr)) {
@@ -52,13 +54,12 @@ template <class A> bool Walker<A>::walkAll() {
           SPDLOG_LOGGER_WARN(
               logger, "Class pointer at {:#x} points outside of image.", pAddr);
         }
-      }
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_catlist", 15) == 0) {
       activity.update(std::nullopt, "Processing categories");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto cAddr = ptrTracker.slideP(pAddr);
 
         if (mCtx.containsAddr(cAddr)) {
@@ -70,16 +71,20 @@ template <class A> bool Walker<A>::walkAll() {
               logger, "Category pointer at {:#x} points outside of image.",
               pAddr);
         }
-      }
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_protolist", 16) == 0) {
       activity.update(std::nullopt, "Processing categories");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      prepareIndex(sectAddr, sectEnd, [&](const PtrT pAddr) {
+        return !mCtx.containsAddr(ptrTracker.slideP(pAddr));
+      });
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto protoAddr = ptrTracker.slideP(pAddr);
 
-        if (mCtx.containsAddr(protoAddr)) {
+        // Protocols can be uniqued into another image
+        if (mCtx.containsAddr(protoAddr) ||
+            getIndex().protocols.contains(protoAddr)) {
           auto &ptr = pointers.protocols.try_emplace(pAddr).first->second;
           ptr.ref = walkProtocol(protoAddr);
           ptr.setFinalAddr(pAddr);
@@ -88,82 +93,100 @@ template <class A> bool Walker<A>::walkAll() {
               logger, "Protocol pointer at {:#x} points outside of image.",
               pAddr);
         }
-      }
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_selrefs", 15) == 0) {
       activity.update(std::nullopt, "Processing selector references");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto stringAddr = ptrTracker.slideP(pAddr);
 
         auto &ptr = pointers.selectorRefs.try_emplace(pAddr).first->second;
         ptr.ref = walkString(stringAddr);
         ptr.setFinalAddr(pAddr);
-      }
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_protorefs", 16) == 0) {
       activity.update(std::nullopt, "Processing protocol references");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto protoAddr = ptrTracker.slideP(pAddr);
 
         auto &ptr = pointers.protocolRefs.try_emplace(pAddr).first->second;
         ptr.ref = walkProtocol(protoAddr);
         ptr.setFinalAddr(pAddr);
-      }
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_classrefs", 16) == 0) {
       activity.update(std::nullopt, "Processing class references");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      prepareIndex(sectAddr, sectEnd, [&](const PtrT pAddr) {
+        auto classAddr = ptrTracker.slideP(pAddr);
+        return !mCtx.containsAddr(classAddr) && !bindRecords.contains(pAddr) &&
+               !shareSymbolicInfo(classAddr);
+      });
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto classAddr = ptrTracker.slideP(pAddr);
 
-        auto &ptr = pointers.classRefs.try_emplace(pAddr).first->second;
-        ptr.setFinalAddr(pAddr);
-
+        // Resolve first, the cache doesn't support removal
+        ClassAtom<A> *ref = nullptr;
+        std::shared_ptr<Provider::SymbolicInfo> bind;
         if (mCtx.containsAddr(classAddr)) {
-          ptr.ref = walkClass(classAddr);
-        } else if (symbolizer.containsAddr(classAddr)) {
-          ptr.bind = symbolizer.shareInfo(classAddr);
+          ref = walkClass(classAddr);
+        } else if (auto info = shareSymbolicInfo(classAddr); info) {
+          bind = std::move(info);
         } else if (bindRecords.contains(pAddr)) {
           auto record = bindRecords.at(pAddr);
-          ptr.bind = std::make_shared<Provider::SymbolicInfo>(
+          bind = std::make_shared<Provider::SymbolicInfo>(
               Provider::SymbolicInfo::Symbol{std::string(record->symbolName),
                                              (uint64_t)record->libOrdinal,
                                              std::nullopt},
               Provider::SymbolicInfo::Encoding::None);
+        } else if (auto info = shareIndexedClassInfo(classAddr); info) {
+          // Last resort, the symbol is inferred from the cache
+          bind = std::move(info);
         } else {
           SPDLOG_LOGGER_WARN(logger,
                              "Unable to fix class ref at {:#x} -> {:#x}.",
                              pAddr, classAddr);
-          pointers.classRefs.erase(pAddr);
+          return;
         }
-      }
+
+        auto &ptr = pointers.classRefs.try_emplace(pAddr).first->second;
+        ptr.setFinalAddr(pAddr);
+        ptr.ref = ref;
+        ptr.bind = std::move(bind);
+      });
     }
 
     else if (memcmp(sect->sectname, "__objc_superrefs", 16) == 0) {
       activity.update(std::nullopt, "Processing super class references");
-      for (PtrT pAddr = sectAddr; pAddr < sectEnd; pAddr += sizeof(PtrT)) {
-        activity.update();
+      prepareIndex(sectAddr, sectEnd, [&](const PtrT pAddr) {
+        auto superAddr = ptrTracker.slideP(pAddr);
+        return !mCtx.containsAddr(superAddr) && !shareSymbolicInfo(superAddr);
+      });
+      forEachPointer(sectAddr, sectEnd, [&](const PtrT pAddr) {
         auto superAddr = ptrTracker.slideP(pAddr);
 
-        auto &ptr = pointers.superRefs.try_emplace(pAddr).first->second;
-        ptr.setFinalAddr(pAddr);
-
+        // Resolve first, the cache doesn't support removal
+        ClassAtom<A> *ref = nullptr;
+        std::shared_ptr<Provider::SymbolicInfo> bind;
         if (mCtx.containsAddr(superAddr)) {
-          ptr.ref = walkClass(superAddr);
-        } else if (symbolizer.containsAddr(superAddr)) {
-          ptr.bind = symbolizer.shareInfo(superAddr);
+          ref = walkClass(superAddr);
+        } else if (auto info = shareClassInfo(superAddr); info) {
+          bind = std::move(info);
         } else {
           SPDLOG_LOGGER_WARN(logger,
                              "Unable to fix super class ref at {:#x} -> {:#x}.",
                              pAddr, superAddr);
-          pointers.superRefs.erase(pAddr);
+          return;
         }
-      }
+
+        auto &ptr = pointers.superRefs.try_emplace(pAddr).first->second;
+        ptr.setFinalAddr(pAddr);
+        ptr.ref = ref;
+        ptr.bind = std::move(bind);
+      });
     }
 
     return true;
@@ -172,9 +195,249 @@ template <class A> bool Walker<A>::walkAll() {
   return true;
 }
 
+template <class A> const typename Walker<A>::ObjcIndex &Walker<A>::getIndex() {
+  std::call_once(indexFlag, [this]() { loadIndex(); });
+  return *index;
+}
+
+template <class A>
+template <class F>
+void Walker<A>::prepareIndex(const PtrT start, const PtrT end,
+                             F &&needsIndex) {
+  if (index) {
+    return;
+  }
+
+  for (auto pAddr = start; pAddr < end; pAddr += sizeof(PtrT)) {
+    if (needsIndex(pAddr)) {
+      getIndex();
+      return;
+    }
+  }
+}
+
+template <class A> void Walker<A>::loadIndex() {
+  if (!accelerator.objcIndex) {
+    if (walking) {
+      // Walk threads are already busy, and can't update the activity
+      accelerator.objcIndex = buildIndex(1);
+    } else {
+      activity.update(std::nullopt, "Indexing ObjC metadata");
+      accelerator.objcIndex = buildIndex(threads);
+    }
+  }
+  index = &*accelerator.objcIndex;
+
+  // Ordinals are the same as the symbolizer's, including itself
+  auto dylibs = mCtx.getAllLCs<Macho::Loader::dylib_command>();
+  for (uint64_t i = 0; i < dylibs.size(); i++) {
+    const std::string path(
+        (char *)((uint8_t *)dylibs[i] + dylibs[i]->dylib.name.offset));
+    if (auto it = accelerator.pathToImage.find(path);
+        it != accelerator.pathToImage.end()) {
+      dylibOrdinals.try_emplace(it->second->address, i);
+    }
+  }
+}
+
+template <class A>
+typename Walker<A>::ObjcIndex
+Walker<A>::buildIndex(const unsigned int maxThreads) const {
+  using ClassInfo = Provider::Accelerator<P>::ObjcClassInfo;
+  using ProtocolInfo = Provider::Accelerator<P>::ObjcProtocolInfo;
+
+  const auto imagesCount = dCtx.images.size();
+  auto readString = [this](PtrT addr) {
+    return addr ? (const char *)dCtx.convertAddrP(addr) : nullptr;
+  };
+
+  // Size the context cache so that images can be loaded concurrently
+  accelerator.imageCtxs.resize(imagesCount);
+
+  // Each part indexes a contiguous range of images
+  struct Part {
+    std::vector<std::pair<PtrT, ProtocolInfo>> protocols;
+    std::vector<std::pair<PtrT, ClassInfo>> classes;
+  };
+  std::vector<Part> parts(maxThreads);
+  Utils::parallelFor(maxThreads, maxThreads, [&](std::size_t i) {
+    auto &part = parts[i];
+    const auto start = imagesCount * i / maxThreads;
+    const auto end = imagesCount * (i + 1) / maxThreads;
+    for (auto imageI = start; imageI < end; imageI++) {
+      const auto image = dCtx.images[imageI];
+      const auto &ctx = accelerator.getImageCtx(dCtx, image);
+      for (const auto &seg : ctx.segments) {
+        for (const auto sect : seg.sections) {
+          const PtrT sectAddr = (PtrT)sect->addr;
+          const PtrT sectEnd = sectAddr + (PtrT)sect->size;
+
+          if (memcmp(sect->sectname, "__objc_protolist", 16) == 0) {
+            for (auto pAddr = sectAddr; pAddr < sectEnd;
+                 pAddr += sizeof(PtrT)) {
+              auto protoAddr = ptrTracker.slideP(pAddr);
+              if (!dCtx.convertAddrP(protoAddr)) {
+                continue;
+              }
+
+              auto proto = ptrTracker.slideS<Objc::protocol_t<P>>(protoAddr);
+              if (auto name = readString(proto.name); name) {
+                part.protocols.emplace_back(protoAddr,
+                                            ProtocolInfo{name, image});
+              }
+            }
+          }
+
+          else if (memcmp(sect->sectname, "__objc_classlist", 16) == 0) {
+            for (auto pAddr = sectAddr; pAddr < sectEnd;
+                 pAddr += sizeof(PtrT)) {
+              auto cAddr = ptrTracker.slideP(pAddr);
+              if (!dCtx.convertAddrP(cAddr)) {
+                continue;
+              }
+
+              auto cls = ptrTracker.slideS<Objc::class_t<P>>(cAddr);
+              auto dataAddr = cls.data & ~Objc::class_t<P>::bitsMask;
+              if (!dataAddr || !dCtx.convertAddrP(dataAddr)) {
+                continue;
+              }
+              auto data = ptrTracker.slideS<Objc::class_data_t<P>>(dataAddr);
+              auto name = readString(data.name);
+              if (!name) {
+                continue;
+              }
+
+              part.classes.emplace_back(cAddr, ClassInfo{name, image, false});
+              if (cls.isa) {
+                part.classes.emplace_back(cls.isa,
+                                          ClassInfo{name, image, true});
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+
+  // Merge in image order
+  ObjcIndex objcIndex;
+  for (const auto &part : parts) {
+    for (const auto &[addr, info] : part.protocols) {
+      objcIndex.protocols.try_emplace(addr, info);
+    }
+    for (const auto &[addr, info] : part.classes) {
+      objcIndex.classes.try_emplace(addr, info);
+    }
+  }
+
+  return objcIndex;
+}
+
+template <class A>
+std::shared_ptr<Provider::SymbolicInfo>
+Walker<A>::shareClassInfo(const PtrT addr) {
+  if (auto info = shareSymbolicInfo(addr); info) {
+    return info;
+  }
+  return shareIndexedClassInfo(addr);
+}
+
+template <class A>
+std::shared_ptr<Provider::SymbolicInfo>
+Walker<A>::shareIndexedClassInfo(const PtrT addr) {
+  const auto &classes = getIndex().classes;
+  auto it = classes.find(addr);
+  if (it == classes.end()) {
+    return nullptr;
+  }
+
+  // Swift classes are not exported with ObjC symbols, and the class must be
+  // in a dependency.
+  const auto &cls = it->second;
+  if (strncmp(cls.name, "_Tt", 3) == 0) {
+    return nullptr;
+  }
+  auto ordinalIt = dylibOrdinals.find(cls.image->address);
+  if (ordinalIt == dylibOrdinals.end()) {
+    return nullptr;
+  }
+
+  return std::make_shared<Provider::SymbolicInfo>(
+      Provider::SymbolicInfo::Symbol{
+          std::string(cls.isMetaclass ? "_OBJC_METACLASS_$_"
+                                      : "_OBJC_CLASS_$_") +
+              cls.name,
+          ordinalIt->second, std::nullopt},
+      Provider::SymbolicInfo::Encoding::None);
+}
+
+template <class A>
+std::shared_ptr<Provider::SymbolicInfo>
+Walker<A>::shareSymbolicInfo(const PtrT addr) {
+  std::scoped_lock lock(symbolizerMutex);
+  if (symbolizer.containsAddr(addr)) {
+    return symbolizer.shareInfo(addr);
+  }
+  return nullptr;
+}
+
+template <class A>
+template <class F>
+void Walker<A>::forEachPointer(const PtrT start, const PtrT end, F &&func) {
+  const std::size_t count = (end - start) / sizeof(PtrT);
+  if (!count) {
+    return;
+  }
+
+  // More chunks than threads, class graphs vary a lot in size
+  const std::size_t chunks = std::min<std::size_t>(count, threads * 4);
+  const auto callerThread = std::this_thread::get_id();
+  walking = true;
+  Utils::parallelFor(chunks, threads, [&](std::size_t i) {
+    const auto chunkStart = count * i / chunks;
+    const auto chunkEnd = count * (i + 1) / chunks;
+    for (auto j = chunkStart; j < chunkEnd; j++) {
+      func(start + (PtrT)(j * sizeof(PtrT)));
+    }
+
+    // Only the calling thread updates the activity
+    if (std::this_thread::get_id() == callerThread) {
+      activity.update();
+    }
+  });
+  walking = false;
+}
+
 template <class A> bool Walker<A>::parseOptInfo() {
+  if (!accelerator.objcOptInfoParsed) {
+    accelerator.objcOptInfo = readOptInfo();
+    accelerator.objcOptInfoParsed = true;
+  } else if (!accelerator.objcOptInfo) {
+    SPDLOG_LOGGER_ERROR(logger, "Unable to read libobjc optimization info.");
+  }
+  if (!accelerator.objcOptInfo) {
+    return false;
+  }
+
+  const auto &optInfo = *accelerator.objcOptInfo;
+  relMethodSelBaseAddr = optInfo.relMethodSelBaseAddr;
+
+  // objc image index
+  auto imageAddr = mCtx.getSegment(SEG_TEXT)->command->vmaddr;
+  auto it = optInfo.imageIndices.find(imageAddr);
+  if (it == optInfo.imageIndices.end()) {
+    SPDLOG_LOGGER_ERROR(logger, "Unable to find objc image index.");
+    return false;
+  }
+
+  imageIndex = it->second;
+  return true;
+}
+
+template <class A>
+std::optional<typename Walker<A>::ObjcOptInfo> Walker<A>::readOptInfo() const {
   // Get libobjc
-  const dyld_cache_image_info *libobjcImageInfo;
+  const dyld_cache_image_info *libobjcImageInfo = nullptr;
   for (const auto info : dCtx.images) {
     if (strstr((const char *)dCtx.file + info->pathFileOffset, "/libobjc.") !=
         nullptr) {
@@ -184,18 +447,22 @@ template <class A> bool Walker<A>::parseOptInfo() {
   }
   if (!libobjcImageInfo) {
     SPDLOG_LOGGER_WARN(logger, "Unable to find image info for libobjc.");
-    return false;
+    return std::nullopt;
   }
-  auto libobjcImage = dCtx.createMachoCtx<true, P>(libobjcImageInfo);
+  const auto &libobjcImage = accelerator.getImageCtx(dCtx, libobjcImageInfo);
 
   // Get __objc_opt_data
   auto optRoSect = libobjcImage.getSection(nullptr, "__objc_opt_ro").second;
   if (!optRoSect) {
     SPDLOG_LOGGER_ERROR(logger, "unable to find __objc_opt_data.");
-    return false;
+    return std::nullopt;
   }
   auto optData = (Objc::objc_opt_t *)libobjcImage.convertAddrP(optRoSect->addr);
 
+  ObjcOptInfo optInfo;
+  optInfo.libobjcImage = libobjcImageInfo;
+  optInfo.version = optData->version;
+
   std::optional<uint64_t> relMethodSelBaseOff;
   uint32_t headerOptOffset;
 
@@ -221,7 +488,7 @@ template <class A> bool Walker<A>::parseOptInfo() {
   default:
     SPDLOG_LOGGER_ERROR(logger, "Unknown opt_data_t version: {}",
                         optData->version);
-    return false;
+    return std::nullopt;
   }
 
   // Selectors
@@ -233,56 +500,44 @@ template <class A> bool Walker<A>::parseOptInfo() {
                sizeof(RELATIVE_METHOD_MAGIC_SELECTOR)) != 0) {
       SPDLOG_LOGGER_ERROR(
           logger, "Relative methods cache does not start with magic selector.");
-      return false;
+      return std::nullopt;
     }
 
-    relMethodSelBaseAddr = addr;
+    optInfo.relMethodSelBaseAddr = addr;
   }
 
-  // objc image index
+  // objc image indices
   if (!headerOptOffset) {
     SPDLOG_LOGGER_ERROR(logger, "opt_data_t does not have header opt.");
-    return false;
+    return std::nullopt;
   }
 
   auto headerOptAddr = optRoSect->addr + headerOptOffset;
   auto headerOpt =
       (Objc::objc_headeropt_ro_t *)libobjcImage.convertAddrP(headerOptAddr);
 
-  auto imageAddr = mCtx.getSegment(SEG_TEXT)->command->vmaddr;
-  std::optional<uint16_t> foundImageIndex;
-
+  optInfo.imageIndices.reserve(headerOpt->count);
   auto headerAddr = headerOptAddr + sizeof(Objc::objc_headeropt_ro_t);
   for (uint32_t i = 0; i < headerOpt->count;
        i++, headerAddr += headerOpt->entsize) {
     auto header =
         (Objc::objc_header_info_ro_t<P> *)libobjcImage.convertAddrP(headerAddr);
-    if (headerAddr + header->mhdr_offset == imageAddr) {
-      foundImageIndex = i;
-      break;
-    }
-  }
-
-  if (!foundImageIndex) {
-    SPDLOG_LOGGER_ERROR(logger, "Unable to find objc image index.");
-    return false;
-  } else {
-    imageIndex = *foundImageIndex;
+    optInfo.imageIndices.try_emplace((PtrT)(headerAddr + header->mhdr_offset),
+                                     (uint16_t)i);
   }
 
-  return true;
+  return optInfo;
 }
 
 template <class A> ClassAtom<A> *Walker<A>::walkClass(const PtrT addr) {
-  if (atoms.classes.contains(addr)) {
-    return &atoms.classes.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.classes.try_emplace(
+      addr, ptrTracker.slideS<Objc::class_t<P>>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.classes.try_emplace(addr, ptrTracker.slideS<Objc::class_t<P>>(addr))
-          .first->second;
-
   // Walk data
   if (auto isaAddr = atom.data.isa; isaAddr) {
     if (mCtx.containsAddr(isaAddr)) {
@@ -290,8 +545,8 @@ template <class A> ClassAtom<A> *Walker<A>::walkClass(const PtrT addr) {
       atom.isa.ref = walkClass(isaAddr);
     } else {
       // Bind
-      if (symbolizer.containsAddr(isaAddr)) {
-        atom.isa.bind = symbolizer.shareInfo(isaAddr);
+      if (auto info = shareClassInfo(isaAddr); info) {
+        atom.isa.bind = std::move(info);
       } else {
         SPDLOG_LOGGER_WARN(
             logger, "Unable to symbolize isa for class_t at {:#x}.", addr);
@@ -307,8 +562,8 @@ template <class A> ClassAtom<A> *Walker<A>::walkClass(const PtrT addr) {
       atom.superclass.ref = walkClass(superAddr);
     } else {
       // Bind
-      if (symbolizer.containsAddr(superAddr)) {
-        atom.superclass.bind = symbolizer.shareInfo(superAddr);
+      if (auto info = shareClassInfo(superAddr); info) {
+        atom.superclass.bind = std::move(info);
       } else {
         // This might be a root class, check
         if (atom.data.data) {
@@ -347,16 +602,14 @@ template <class A> ClassAtom<A> *Walker<A>::walkClass(const PtrT addr) {
 }
 
 template <class A> ClassDataAtom<A> *Walker<A>::walkClassData(const PtrT addr) {
-  if (atoms.classData.contains(addr)) {
-    return &atoms.classData.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.classData.try_emplace(
+      addr, ptrTracker.slideS<Objc::class_data_t<P>>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.classData
-          .try_emplace(addr, ptrTracker.slideS<Objc::class_data_t<P>>(addr))
-          .first->second;
-
   // Walk data
   if (atom.data.ivarLayout) {
     atom.ivarLayout.ref = walkIvarLayout(atom.data.ivarLayout);
@@ -424,10 +677,6 @@ template <class A> ClassDataAtom<A> *Walker<A>::walkClassData(const PtrT addr) {
 
 template <class A>
 IvarLayoutAtom<typename A::P> *Walker<A>::walkIvarLayout(const PtrT addr) {
-  if (atoms.ivarLayouts.contains(addr)) {
-    return &atoms.ivarLayouts.at(addr);
-  }
-
   // Make new atom
   return &atoms.ivarLayouts.try_emplace(addr, dCtx.convertAddrP(addr))
               .first->second;
@@ -435,10 +684,6 @@ IvarLayoutAtom<typename A::P> *Walker<A>::walkIvarLayout(const PtrT addr) {
 
 template <class A>
 StringAtom<typename A::P> *Walker<A>::walkString(const PtrT addr) {
-  if (atoms.strings.contains(addr)) {
-    return &atoms.strings.at(addr);
-  }
-
   // Make new atom
   return &atoms.strings.try_emplace(addr, (const char *)dCtx.convertAddrP(addr))
               .first->second;
@@ -457,13 +702,13 @@ MethodListAtom<typename A::P> *Walker<A>::walkMethodList(const PtrT addr) {
 template <class A>
 SmallMethodListAtom<typename A::P> *
 Walker<A>::walkSmallMethodList(const PtrT addr, Objc::method_list_t data) {
-  if (atoms.smallMethodLists.contains(addr)) {
-    return &atoms.smallMethodLists.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.smallMethodLists.try_emplace(addr, data);
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom = atoms.smallMethodLists.try_emplace(addr, data).first->second;
-
   // Remove flag
   if (atom.data.entsizeAndFlags &
       Objc::method_list_t::relativeMethodSelectorsAreDirectFlag) {
@@ -538,13 +783,13 @@ LargeMethodListAtom<typename A::P> *
 Walker<A>::walkLargeMethodList(const PtrT addr, Objc::method_list_t data) {
   assert(!data.usesRelativeMethods());
 
-  if (atoms.largeMethodLists.contains(addr)) {
-    return &atoms.largeMethodLists.at(addr);
+  // make new atom, or use the existing one
+  auto [entry, inserted] = atoms.largeMethodLists.try_emplace(addr, data);
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // make new atom
-  auto &atom = atoms.largeMethodLists.try_emplace(addr, data).first->second;
-
   // walk methods
   using MethodT = Objc::method_large_t<P>;
   PtrT entsize = atom.data.getEntsize();
@@ -593,16 +838,14 @@ Walker<A>::walkLargeMethodList(const PtrT addr, Objc::method_list_t data) {
 
 template <class A>
 ProtocolListAtom<A> *Walker<A>::walkProtocolList(const PtrT addr) {
-  if (atoms.protocolLists.contains(addr)) {
-    return &atoms.protocolLists.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.protocolLists.try_emplace(
+      addr, ptrTracker.slideS<Objc::protocol_list_t<P>>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.protocolLists
-          .try_emplace(addr, ptrTracker.slideS<Objc::protocol_list_t<P>>(addr))
-          .first->second;
-
   // Walk data
   PtrT protoRefAddr = addr + sizeof(Objc::protocol_list_t<P>);
   for (PtrT i = 0; i < atom.data.count; i++, protoRefAddr += sizeof(PtrT)) {
@@ -614,16 +857,14 @@ ProtocolListAtom<A> *Walker<A>::walkProtocolList(const PtrT addr) {
 }
 
 template <class A> ProtocolAtom<A> *Walker<A>::walkProtocol(const PtrT addr) {
-  if (atoms.protocols.contains(addr)) {
-    return &atoms.protocols.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.protocols.try_emplace(
+      addr, ptrTracker.slideS<Objc::protocol_t<P>>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.protocols
-          .try_emplace(addr, ptrTracker.slideS<Objc::protocol_t<P>>(addr))
-          .first->second;
-
   // Walk data
   if (auto isaAddr = atom.data.isa; isaAddr) {
     if (mCtx.containsAddr(isaAddr)) {
@@ -631,8 +872,8 @@ template <class A> ProtocolAtom<A> *Walker<A>::walkProtocol(const PtrT addr) {
       atom.isa.ref = walkClass(isaAddr);
     } else {
       // Bind
-      if (symbolizer.containsAddr(isaAddr)) {
-        atom.isa.bind = symbolizer.shareInfo(isaAddr);
+      if (auto info = shareClassInfo(isaAddr); info) {
+        atom.isa.bind = std::move(info);
       } else {
         SPDLOG_LOGGER_WARN(
             logger, "Unable to symbolize isa ({:#x}) for protocol_t at {:#x}.",
@@ -698,16 +939,14 @@ template <class A> ProtocolAtom<A> *Walker<A>::walkProtocol(const PtrT addr) {
 
 template <class A>
 PropertyListAtom<typename A::P> *Walker<A>::walkPropertyList(const PtrT addr) {
-  if (atoms.propertyLists.contains(addr)) {
-    return &atoms.propertyLists.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.propertyLists.try_emplace(
+      addr, ptrTracker.slideS<Objc::property_list_t>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.propertyLists
-          .try_emplace(addr, ptrTracker.slideS<Objc::property_list_t>(addr))
-          .first->second;
-
   auto entsize = atom.data.entsize;
   if (entsize != sizeof(Objc::property_t<P>)) {
     SPDLOG_LOGGER_ERROR(logger,
@@ -744,18 +983,17 @@ PropertyListAtom<typename A::P> *Walker<A>::walkPropertyList(const PtrT addr) {
 template <class A>
 ExtendedMethodTypesAtom<typename A::P> *
 Walker<A>::walkExtendedMethodTypes(const PtrT addr, const uint32_t count) {
-  if (atoms.extendedMethodTypes.contains(addr)) {
-    auto &atom = atoms.extendedMethodTypes.at(addr);
-    if (atom.entries.size() != count) {
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.extendedMethodTypes.try_emplace(addr, count);
+  auto &atom = entry->second;
+  if (!inserted) {
+    if (atom.count != count) {
       SPDLOG_LOGGER_WARN(
           logger, "Conflicting count for extendedMethodTypes at {:#x}.", addr);
-      return &atom;
     }
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom = atoms.extendedMethodTypes.try_emplace(addr).first->second;
-
   // walk data
   PtrT pAddr = addr;
   for (uint32_t i = 0; i < count; i++, pAddr += sizeof(PtrT)) {
@@ -766,16 +1004,14 @@ Walker<A>::walkExtendedMethodTypes(const PtrT addr, const uint32_t count) {
 }
 
 template <class A> IvarListAtom<A> *Walker<A>::walkIvarList(const PtrT addr) {
-  if (atoms.ivarLists.contains(addr)) {
-    return &atoms.ivarLists.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.ivarLists.try_emplace(
+      addr, ptrTracker.slideS<Objc::ivar_list_t>(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.ivarLists
-          .try_emplace(addr, ptrTracker.slideS<Objc::ivar_list_t>(addr))
-          .first->second;
-
   auto entsize = atom.data.entsize;
   if (entsize != sizeof(Objc::ivar_t<P>)) {
     SPDLOG_LOGGER_ERROR(
@@ -819,10 +1055,6 @@ template <class A> IvarListAtom<A> *Walker<A>::walkIvarList(const PtrT addr) {
 
 template <class A>
 IvarOffsetAtom<A> *Walker<A>::walkIvarOffset(const PtrT addr) {
-  if (atoms.ivarOffsets.contains(addr)) {
-    return &atoms.ivarOffsets.at(addr);
-  }
-
   // Make new atom
   return &atoms.ivarOffsets
               .try_emplace(addr, *(IvarOffsetType<A> *)dCtx.convertAddrP(addr))
@@ -830,17 +1062,15 @@ IvarOffsetAtom<A> *Walker<A>::walkIvarOffset(const PtrT addr) {
 }
 
 template <class A> CategoryAtom<A> *Walker<A>::walkCategory(const PtrT addr) {
-  if (atoms.categories.contains(addr)) {
-    return &atoms.categories.at(addr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.categories.try_emplace(
+      addr, ptrTracker.slideS<Objc::category_t<P>>(addr),
+      hasCategoryClassProperties);
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make new atom
-  auto &atom =
-      atoms.categories
-          .try_emplace(addr, ptrTracker.slideS<Objc::category_t<P>>(addr),
-                       hasCategoryClassProperties)
-          .first->second;
-
   // walk data
   if (atom.data.name) {
     atom.name.ref = walkString(atom.data.name);
@@ -855,8 +1085,8 @@ template <class A> CategoryAtom<A> *Walker<A>::walkCategory(const PtrT addr) {
       atom.cls.ref = walkClass(clsAddr);
     } else {
       // Bind
-      if (symbolizer.containsAddr(clsAddr)) {
-        atom.cls.bind = symbolizer.shareInfo(clsAddr);
+      if (auto info = shareClassInfo(clsAddr); info) {
+        atom.cls.bind = std::move(info);
       } else {
         SPDLOG_LOGGER_WARN(
             logger, "Unable to symbolize cls ({:#x}) for category_t at {:#x}.",
@@ -892,15 +1122,14 @@ template <class A> CategoryAtom<A> *Walker<A>::walkCategory(const PtrT addr) {
 }
 
 template <class A> ImpAtom<typename A::P> *Walker<A>::walkImp(const PtrT addr) {
-  if (atoms.imps.contains(addr)) {
-    return &atoms.imps.at(addr);
+  // Make atom, or use the existing one
+  auto [entry, inserted] = atoms.imps.try_emplace(
+      addr, (const uint8_t *)dCtx.convertAddrP(addr));
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
 
-  // Make atom
-  auto &atom =
-      atoms.imps.try_emplace(addr, (const uint8_t *)dCtx.convertAddrP(addr))
-          .first->second;
-
   // Set finalAddr now
   atom.setFinalAddr(addr);
   return &atom;
@@ -909,12 +1138,12 @@ template <class A> ImpAtom<typename A::P> *Walker<A>::walkImp(const PtrT addr) {
 template <class A>
 PointerAtom<typename A::P, StringAtom<typename A::P>> *
 Walker<A>::makeSmallMethodSelRef(const PtrT stringAddr) {
-  if (atoms.smallMethodSelRefs.contains(stringAddr)) {
-    return &atoms.smallMethodSelRefs.at(stringAddr);
+  // Make new atom, or use the existing one
+  auto [entry, inserted] = atoms.smallMethodSelRefs.try_emplace(stringAddr);
+  auto &atom = entry->second;
+  if (!inserted) {
+    return &atom;
   }
-
-  // Make new atom
-  auto &atom = atoms.smallMethodSelRefs.try_emplace(stringAddr).first->second;
   atom.ref = walkString(stringAddr);
   return &atom;
 }
@@ -3,7 +3,9 @@
 
 #include "Atoms.h"
 #include <Objc/Abstraction.h>
+#include <Utils/ArenaMap.h>
 #include <Utils/ExtractionContext.h>
+#include <mutex>
 #include <optional>
 
 namespace DyldExtractor::Converter::ObjcFixer {
@@ -21,7 +23,23 @@ public:
   bool walkAll();
 
 private:
+  using ObjcOptInfo = Provider::Accelerator<P>::ObjcOptInfo;
+  using ObjcIndex = Provider::Accelerator<P>::ObjcIndex;
+
   bool parseOptInfo();
+  /// @brief Read libobjc's optimization info, only needed once per cache.
+  std::optional<ObjcOptInfo> readOptInfo() const;
+  /// @brief Index ObjC metadata of all images, only needed once per cache.
+  /// @param maxThreads Maximum number of threads used to index images.
+  ObjcIndex buildIndex(const unsigned int maxThreads) const;
+  /// @brief Get the cache index, it is only built when a lookup first needs
+  ///   it. Can be called from any walk thread, but is built serially there.
+  const ObjcIndex &getIndex();
+  /// @brief Build the cache index before a section is walked, if any of its
+  ///   pointers needs it. Only called from the thread that walks the image.
+  template <class F>
+  void prepareIndex(const PtrT start, const PtrT end, F &&needsIndex);
+  void loadIndex();
 
   ClassAtom<A> *walkClass(const PtrT addr);
   ClassDataAtom<A> *walkClassData(const PtrT addr);
@@ -49,21 +67,57 @@ private:
   /// @return Address of the list
   std::optional<PtrT> findInImageRelList(const PtrT addr) const;
 
+  /// @brief Get symbolic info for a bind, safe to call from any walk thread.
+  /// @param addr The address without instruction bits
+  /// @return A shared pointer to the info, or a nullptr.
+  std::shared_ptr<Provider::SymbolicInfo> shareSymbolicInfo(const PtrT addr);
+
+  /// @brief Get symbolic info for a class outside of the image. Falls back to
+  ///   the cache index if the symbolizer doesn't know the class.
+  /// @param addr The address of the class_t
+  /// @return A shared pointer to the info, or a nullptr.
+  std::shared_ptr<Provider::SymbolicInfo> shareClassInfo(const PtrT addr);
+
+  /// @brief Get symbolic info for a class outside of the image, only from the
+  ///   cache index. The symbol is inferred from the class name.
+  /// @param addr The address of the class_t
+  /// @return A shared pointer to the info, or a nullptr.
+  std::shared_ptr<Provider::SymbolicInfo>
+  shareIndexedClassInfo(const PtrT addr);
+
+  /// @brief Call a function for every pointer in a section. The section is
+  ///   split into chunks that are walked in parallel.
+  template <class F>
+  void forEachPointer(const PtrT start, const PtrT end, F &&func);
+
   const Dyld::Context &dCtx;
   Macho::Context<false, P> &mCtx;
+  Provider::Accelerator<P> &accelerator;
   Provider::ActivityLogger &activity;
   std::shared_ptr<spdlog::logger> logger;
 
   Provider::BindInfo<P> &bindInfo;
   Provider::PointerTracker<P> &ptrTracker;
   Provider::Symbolizer<A> &symbolizer;
+  /// Lazy symbolizer lookups update it
+  std::mutex symbolizerMutex;
 
+  unsigned int threads;
   uint16_t imageIndex;
   bool hasCategoryClassProperties = false;
   std::optional<PtrT> relMethodSelBaseAddr;
 
-  /// @brief Cache of atoms, keys are the original addresses
-  template <class T> using CacheT = std::map<PtrT, T>;
+  /// If forEachPointer is running, only changed while no walk threads are
+  ///   running.
+  bool walking = false;
+  std::once_flag indexFlag;
+  const ObjcIndex *index = nullptr;
+  /// Ordinals of dependencies, by the address of their image
+  Utils::FlatHashMap<uint64_t, uint64_t> dylibOrdinals;
+
+  /// @brief Cache of atoms, keys are the original addresses. Atoms are
+  ///   inserted once by any walk thread and iterated in address order.
+  template <class T> using CacheT = Utils::ConcurrentArenaMap<PtrT, T>;
   struct {
     CacheT<ClassAtom<A>> classes;
     CacheT<ClassDataAtom<A>> classData;
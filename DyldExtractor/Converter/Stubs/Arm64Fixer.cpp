@@ -1,6 +1,7 @@
 #include "Arm64Fixer.h"
 
 #include "Fixer.h"
+#include <Utils/Threading.h>
 #include <Utils/Utils.h>
 
 using namespace DyldExtractor;
@@ -92,10 +93,10 @@ template <class A> void Arm64Fixer<A>::scanStubs() {
   activity.update(std::nullopt, "Scanning Stubs");
 
   mCtx.enumerateSections(
-      [](auto seg, auto sect) {
+      [](const auto &seg, auto sect) {
         return (sect->flags & SECTION_TYPE) == S_SYMBOL_STUBS;
       },
-      [this](auto seg, auto sect) {
+      [this](const auto &seg, auto sect) {
         auto sAddr = sect->addr;
         auto sLoc = mCtx.convertAddrP(sAddr);
         auto indirectI = sect->reserved1;
@@ -125,7 +126,7 @@ template <class A> void Arm64Fixer<A>::scanStubs() {
             const auto &[strIt, entry] =
                 stTracker.getSymbol(stTracker.indirectSyms.at(indirectI));
             uint64_t ordinal = GET_LIBRARY_ORDINAL(entry.n_desc);
-            symbols.insert({*strIt, ordinal, std::nullopt});
+            symbols.insert({std::string(strIt->str), ordinal, std::nullopt});
           }
 
           // Though its pointer if not optimized
@@ -162,6 +163,7 @@ template <class A> void Arm64Fixer<A>::scanStubs() {
                         {symbols, Provider::SymbolicInfo::Encoding::None});
             brokenStubs.emplace_back(sFormat, sTargetFunc, sAddr, sLoc,
                                      stubSize);
+            targetStubMap.try_emplace(sTargetFunc, sAddr);
           } else {
             SPDLOG_LOGGER_WARN(logger, "Unable to symbolize stub at {:#x}.",
                                sAddr);
@@ -320,36 +322,34 @@ template <class A> void Arm64Fixer<A>::fixPass2() {
       // Try to find an unused named lazy pointer
       PtrT pAddr = 0;
       for (const auto &sym : sSymbols.symbols) {
-        if (pointerCache.reverse.lazy.contains(sym.name)) {
-          for (const auto ptr : pointerCache.reverse.lazy[sym.name]) {
-            if (!pointerCache.used.lazy.contains(ptr)) {
-              pAddr = ptr;
-              pointerCache.used.lazy.insert(ptr);
-              break;
-            }
-          }
-          if (pAddr) {
+        for (const auto ptr :
+             pointerCache.getNamedPointers(SPointerType::lazy, sym.name)) {
+          if (!pointerCache.used.lazy.contains(ptr)) {
+            pAddr = ptr;
+            pointerCache.used.lazy.insert(ptr);
             break;
           }
         }
+        if (pAddr) {
+          break;
+        }
       }
 
       // Try to find an unused named normal pointer
       if (!pAddr) {
         for (const auto &sym : sSymbols.symbols) {
-          if (pointerCache.reverse.normal.contains(sym.name)) {
-            for (const auto ptr : pointerCache.reverse.normal[sym.name]) {
-              if (!pointerCache.used.normal.contains(ptr)) {
-                pAddr = ptr;
-                pointerCache.used.normal.insert(ptr);
-                ptrTracker.add(pAddr, 0);
-                break;
-              }
-            }
-            if (pAddr) {
+          for (const auto ptr :
+               pointerCache.getNamedPointers(SPointerType::normal, sym.name)) {
+            if (!pointerCache.used.normal.contains(ptr)) {
+              pAddr = ptr;
+              pointerCache.used.normal.insert(ptr);
+              ptrTracker.add(pAddr, 0);
               break;
             }
           }
+          if (pAddr) {
+            break;
+          }
         }
       }
 
@@ -384,17 +384,16 @@ template <class A> void Arm64Fixer<A>::fixPass2() {
       // Try to find an unused named pointer
       PtrT pAddr = 0;
       for (const auto &sym : sSymbols.symbols) {
-        if (pointerCache.reverse.auth.contains(sym.name)) {
-          for (const auto ptr : pointerCache.reverse.auth[sym.name]) {
-            if (!pointerCache.used.auth.contains(ptr)) {
-              pAddr = ptr;
-              break;
-            }
-          }
-          if (pAddr) {
+        for (const auto ptr :
+             pointerCache.getNamedPointers(SPointerType::auth, sym.name)) {
+          if (!pointerCache.used.auth.contains(ptr)) {
+            pAddr = ptr;
             break;
           }
         }
+        if (pAddr) {
+          break;
+        }
       }
 
       if (!pAddr && !pointerCache.unnamed.auth.empty()) {
@@ -436,10 +435,61 @@ template <class A> void Arm64Fixer<A>::fixPass2() {
 template <class A> void Arm64Fixer<A>::fixCallsites() {
   activity.update(std::nullopt, "Fixing Callsites");
   const auto textSect = mCtx.getSection(SEG_TEXT, SECT_TEXT).second;
+  const auto threads = delegate.eCtx.options.threads;
+
+  // Split the text by functions, each part can be fixed independently
+  auto &funcTracker = delegate.eCtx.funcTracker;
+  funcTracker.load();
+  const auto boundaries = funcTracker.partition(
+      textSect->addr, textSect->addr + textSect->size, threads);
+  const auto partsCount = boundaries.size() - 1;
+
+  std::vector<std::vector<Callsite>> callsites(partsCount);
+  Utils::parallelFor(partsCount, threads, [&](std::size_t i) {
+    callsites[i] = scanCallsites(textSect->addr, boundaries[i],
+                                 boundaries[i + 1]);
+  });
+  activity.update();
+
+  /**
+   * Resolving targets writes to the accelerator, so it is done serially
+   * beforehand. Afterwards the targets are only read.
+   */
+  std::unordered_map<PtrT, CallsiteTarget> targets;
+  for (const auto &part : callsites) {
+    for (const auto &callsite : part) {
+      if (!targets.contains(callsite.target)) {
+        targets.emplace(callsite.target, resolveCallsite(callsite.target));
+        activity.update();
+      }
+    }
+  }
+
+  // Logs are collected per part, and emitted in address order
+  std::vector<std::vector<std::string>> logs(partsCount);
+  Utils::parallelFor(partsCount, threads, [&](std::size_t i) {
+    for (const auto &callsite : callsites[i]) {
+      if (auto msg = fixCallsite(callsite, targets.at(callsite.target)); msg) {
+        logs[i].push_back(std::move(*msg));
+      }
+    }
+  });
 
-  auto iAddr = textSect->addr;
+  for (const auto &partLogs : logs) {
+    for (const auto &msg : partLogs) {
+      SPDLOG_LOGGER_WARN(logger, "{}", msg);
+    }
+  }
+}
+
+template <class A>
+std::vector<typename Arm64Fixer<A>::Callsite>
+Arm64Fixer<A>::scanCallsites(PtrT textAddr, PtrT start, PtrT end) const {
+  std::vector<Callsite> callsites;
+
+  auto iAddr = start;
   auto iLoc = mCtx.convertAddrP(iAddr);
-  for (; iAddr < textSect->addr + textSect->size; iAddr += 4, iLoc += 4) {
+  for (; iAddr < end; iAddr += 4, iLoc += 4) {
     /**
      * We are only looking for bl and b instructions only.
      * Theses instructions are only identical by their top
@@ -461,108 +511,127 @@ template <class A> void Arm64Fixer<A>::fixCallsites() {
       continue;
     }
 
-    const auto brTargetFunc = arm64Utils.resolveStubChain(brTarget);
-    auto names = symbolizer.symbolizeAddr(brTargetFunc);
-
-    if (!names) {
-      // There might be a stub hiding the export name, walk up the chain to try
-      // to recover
-      auto chain = arm64Utils.resolveStubChainExtended(brTarget);
-      if (chain.size()) {
-        for (auto it = std::next(chain.crbegin()); it != chain.crend(); it++) {
-          names = symbolizer.symbolizeAddr(it->first);
-          if (names) {
-            break;
-          }
-        }
-        if (!names) {
-          names = symbolizer.symbolizeAddr(brTarget); // Try very first stub
-        }
-      }
+    /**
+     * Sometimes there are bytes of data in the text section
+     * that match the bl and b filter, these seem to follow a
+     * BR or other branch. Check the last instruction before
+     * any callsites are modified.
+     */
+    bool afterBranch = false;
+    if (iAddr != textAddr) {
+      const auto lastInstrTop = *(iLoc - 1) & 0xFC;
+      afterBranch = lastInstrTop == 0x94 || lastInstrTop == 0x14 ||
+                    lastInstrTop == 0xD4;
     }
 
-    // Try to fix stub
-    bool stubFixed = false;
-    if (names) {
-      for (const auto &name : names->symbols) {
-        if (reverseStubMap.contains(name.name)) {
-          const auto stubAddr = *reverseStubMap[name.name].begin();
-          const auto imm26 = ((SPtrT)stubAddr - iAddr) >> 2;
-          *brInstr = (*brInstr & 0xFC000000) | (uint32_t)imm26;
-          stubFixed = true;
+    callsites.emplace_back(iAddr, brTarget, brInstr, afterBranch);
+  }
+
+  return callsites;
+}
+
+template <class A>
+Arm64Fixer<A>::CallsiteTarget Arm64Fixer<A>::resolveCallsite(PtrT brTarget) {
+  const auto brTargetFunc = arm64Utils.resolveStubChain(brTarget);
+
+  // Most branches go to a function that a stub also goes to
+  if (auto it = targetStubMap.find(brTargetFunc); it != targetStubMap.end()) {
+    return {brTargetFunc, nullptr, it->second};
+  }
+
+  // Otherwise try to match a stub by its symbols
+  auto names = symbolizer.symbolizeAddr(brTargetFunc);
+
+  if (!names) {
+    // There might be a stub hiding the export name, walk up the chain to try
+    // to recover
+    auto chain = arm64Utils.resolveStubChainExtended(brTarget);
+    if (chain.size()) {
+      for (auto it = std::next(chain.crbegin()); it != chain.crend(); it++) {
+        names = symbolizer.symbolizeAddr(it->first);
+        if (names) {
           break;
         }
       }
-
-      if (stubFixed) {
-        activity.update();
-        continue;
+      if (!names) {
+        names = symbolizer.symbolizeAddr(brTarget); // Try very first stub
       }
     }
+  }
 
-    if (!stubFixed) {
-      /**
-       * Sometimes there are bytes of data in the text section
-       * that match the bl and b filter, these seem to follow a
-       * BR or other branch, skip these.
-       */
-      if (iAddr != textSect->addr) {
-        const auto lastInstrTop = *(iLoc - 1) & 0xFC;
-        if (lastInstrTop == 0x94 || lastInstrTop == 0x14 ||
-            lastInstrTop == 0xD4) {
-          continue;
-        }
+  // Find a stub
+  std::optional<PtrT> stubAddr;
+  if (names) {
+    for (const auto &name : names->symbols) {
+      if (auto it = reverseStubMap.find(name.name);
+          it != reverseStubMap.end()) {
+        stubAddr = *it->second.begin();
+        break;
       }
+    }
+  }
 
-      if (brTarget == brTargetFunc) {
-        // it probably isn't a branch if it didn't go though any stubs...
-        continue;
-      }
+  return {brTargetFunc, names, stubAddr};
+}
 
-      // Check if it's pointing to code
-      if (!delegate.isInCodeRegions(brTargetFunc)) {
-        continue;
-      }
+template <class A>
+std::optional<std::string>
+Arm64Fixer<A>::fixCallsite(const Callsite &callsite,
+                           const CallsiteTarget &target) const {
+  const auto iAddr = callsite.addr;
+  const auto brTarget = callsite.target;
+  const auto brTargetFunc = target.func;
+
+  // Try to fix stub
+  if (target.stub) {
+    const auto imm26 = ((SPtrT)*target.stub - iAddr) >> 2;
+    *callsite.loc = (*callsite.loc & 0xFC000000) | (uint32_t)imm26;
+    return std::nullopt;
+  }
 
-      // It might be in a non code region, check if the previous instructions
-      // are invalid
-      auto inst = disasm.instructionAtAddr(iAddr);
-      if (inst == disasm.instructionsEnd()) {
-        continue;
-      }
+  if (callsite.afterBranch) {
+    return std::nullopt;
+  }
 
-      bool invalidInst = false;
-      for (int i = 0; inst != disasm.instructionsBegin() && i <= 2;
-           inst--, i++) {
-        if (inst->id == DISASM_INVALID_INSN) {
-          invalidInst = true;
-          break;
-        }
-      }
-      if (invalidInst) {
-        continue;
-      }
-    }
+  if (brTarget == brTargetFunc) {
+    // it probably isn't a branch if it didn't go though any stubs...
+    return std::nullopt;
+  }
 
-    if (!names) {
-      SPDLOG_LOGGER_WARN(logger,
-                         "Unable to symbolize branch at {:#x} with target "
-                         "{:#x} and destination {:#x}.",
-                         iAddr, brTarget, brTargetFunc);
-    } else {
-      const auto &symbols = names->symbols;
-      std::string symbolNames;
-      for (auto it = symbols.cbegin(); it != std::prev(symbols.cend()); it++) {
-        symbolNames += it->name + ", ";
-      }
-      symbolNames += symbols.crbegin()->name;
+  // Check if it's pointing to code
+  if (!delegate.isInCodeRegions(brTargetFunc)) {
+    return std::nullopt;
+  }
 
-      SPDLOG_LOGGER_WARN(logger,
-                         "Unable to find stub for branch at {:#x}, with target "
-                         "{:#x}, with symbols {}.",
-                         iAddr, brTarget, symbolNames);
+  // It might be in a non code region, check if the previous instructions
+  // are invalid
+  auto inst = disasm.instructionAtAddr(iAddr);
+  if (inst == disasm.instructionsEnd()) {
+    return std::nullopt;
+  }
+
+  for (int i = 0; inst != disasm.instructionsBegin() && i <= 2; inst--, i++) {
+    if (inst->id == DISASM_INVALID_INSN) {
+      return std::nullopt;
     }
   }
+
+  if (!target.names) {
+    return fmt::format("Unable to symbolize branch at {:#x} with target "
+                       "{:#x} and destination {:#x}.",
+                       iAddr, brTarget, brTargetFunc);
+  } else {
+    const auto &symbols = target.names->symbols;
+    std::string symbolNames;
+    for (auto it = symbols.cbegin(); it != std::prev(symbols.cend()); it++) {
+      symbolNames += it->name + ", ";
+    }
+    symbolNames += symbols.crbegin()->name;
+
+    return fmt::format("Unable to find stub for branch at {:#x}, with target "
+                       "{:#x}, with symbols {}.",
+                       iAddr, brTarget, symbolNames);
+  }
 }
 
 template class Arm64Fixer<Utils::Arch::arm64>;
@@ -3,6 +3,7 @@
 
 #include "Arm64Utils.h"
 #include "SymbolPointerCache.h"
+#include <unordered_map>
 
 namespace DyldExtractor::Converter::Stubs {
 
@@ -31,12 +32,31 @@ private:
     uint32_t size; // Size in bytes of the stub
   };
 
+  struct Callsite {
+    PtrT addr;
+    PtrT target;      // Branch target, outside of the image
+    uint32_t *loc;    // Writable location of the branch
+    bool afterBranch; // If the previous instruction looks like a branch
+  };
+
+  struct CallsiteTarget {
+    PtrT func; // The target after resolving stub chains
+    const Provider::SymbolicInfo *names;
+    std::optional<PtrT> stub; // Stub to branch to instead
+  };
+
   void fixStubHelpers();
   void scanStubs();
   void fixPass1();
   void fixPass2();
   void fixCallsites();
 
+  std::vector<Callsite> scanCallsites(PtrT textAddr, PtrT start,
+                                      PtrT end) const;
+  CallsiteTarget resolveCallsite(PtrT brTarget);
+  std::optional<std::string> fixCallsite(const Callsite &callsite,
+                                         const CallsiteTarget &target) const;
+
   void addStubInfo(PtrT sAddr, Provider::SymbolicInfo info);
 
   Fixer<A> &delegate;
@@ -56,6 +76,9 @@ private:
            std::less<const std::string>>
       reverseStubMap;
 
+  /// Maps the function a stub resolves to, to the first stub that does so.
+  std::unordered_map<PtrT, PtrT> targetStubMap;
+
   std::list<StubInfo> brokenStubs;
 };
 
@@ -1,6 +1,7 @@
 #include "ArmFixer.h"
 
 #include "Fixer.h"
+#include <Utils/Threading.h>
 #include <Utils/Utils.h>
 
 using namespace DyldExtractor;
@@ -10,7 +11,7 @@ using namespace Stubs;
 ArmFixer::ArmFixer(Fixer<A> &delegate)
     : delegate(delegate), mCtx(delegate.mCtx), activity(delegate.activity),
       logger(delegate.logger), bindInfo(delegate.bindInfo),
-      disasm(delegate.disasm), ptrTracker(delegate.ptrTracker),
+      funcTracker(delegate.eCtx.funcTracker), ptrTracker(delegate.ptrTracker),
       symbolizer(delegate.symbolizer),
       stTracker(delegate.eCtx.stTracker.value()),
       pointerCache(delegate.ptrCache), armUtils(*delegate.armUtils) {}
@@ -98,10 +99,10 @@ void ArmFixer::scanStubs() {
   activity.update(std::nullopt, "Scanning Stubs");
 
   mCtx.enumerateSections(
-      [](auto seg, auto sect) {
+      [](const auto &seg, auto sect) {
         return (sect->flags & SECTION_TYPE) == S_SYMBOL_STUBS;
       },
-      [this](auto seg, auto sect) {
+      [this](const auto &seg, auto sect) {
         const auto sSize = sect->reserved2;
         auto sLoc = mCtx.convertAddrP(sect->addr);
         uint32_t indirectI = sect->reserved1;
@@ -128,7 +129,7 @@ void ArmFixer::scanStubs() {
             const auto &[strIt, entry] =
                 stTracker.getSymbol(stTracker.indirectSyms.at(indirectI));
             uint64_t ordinal = GET_LIBRARY_ORDINAL(entry.n_desc);
-            symbols.insert({*strIt, ordinal, std::nullopt});
+            symbols.insert({std::string(strIt->str), ordinal, std::nullopt});
           }
 
           // Though its pointer if not optimized
@@ -156,6 +157,7 @@ void ArmFixer::scanStubs() {
             addStubInfo(sAddr,
                         {symbols, Provider::SymbolicInfo::Encoding::None});
             brokenStubs.emplace_back(sFormat, sTargetFunc, sAddr, sLoc);
+            targetStubMap.try_emplace(sTargetFunc, sAddr);
           } else {
             SPDLOG_LOGGER_WARN(logger, "Unable to symbolize stub at {:#x}.",
                                sAddr);
@@ -239,36 +241,34 @@ void ArmFixer::fixPass2() {
       // Try to find an unused named lazy pointer
       PtrT pAddr = 0;
       for (const auto &sym : sSymbols.symbols) {
-        if (pointerCache.reverse.lazy.contains(sym.name)) {
-          for (const auto ptr : pointerCache.reverse.lazy[sym.name]) {
-            if (!pointerCache.used.lazy.contains(ptr)) {
-              pAddr = ptr;
-              pointerCache.used.lazy.insert(ptr);
-              break;
-            }
-          }
-          if (pAddr) {
+        for (const auto ptr :
+             pointerCache.getNamedPointers(SPointerType::lazy, sym.name)) {
+          if (!pointerCache.used.lazy.contains(ptr)) {
+            pAddr = ptr;
+            pointerCache.used.lazy.insert(ptr);
             break;
           }
         }
+        if (pAddr) {
+          break;
+        }
       }
 
       // Try to find an unused named normal pointer
       if (!pAddr) {
         for (const auto &sym : sSymbols.symbols) {
-          if (pointerCache.reverse.normal.contains(sym.name)) {
-            for (const auto ptr : pointerCache.reverse.normal[sym.name]) {
-              if (!pointerCache.used.normal.contains(ptr)) {
-                pAddr = ptr;
-                pointerCache.used.normal.insert(ptr);
-                ptrTracker.add(ptr, 0);
-                break;
-              }
-            }
-            if (pAddr) {
+          for (const auto ptr :
+               pointerCache.getNamedPointers(SPointerType::normal, sym.name)) {
+            if (!pointerCache.used.normal.contains(ptr)) {
+              pAddr = ptr;
+              pointerCache.used.normal.insert(ptr);
+              ptrTracker.add(ptr, 0);
               break;
             }
           }
+          if (pAddr) {
+            break;
+          }
         }
       }
 
@@ -306,104 +306,197 @@ void ArmFixer::fixPass2() {
 
 void ArmFixer::fixCallsites() {
   activity.update(std::nullopt, "Fixing Callsites");
-  const auto textSect = mCtx.getSection(SEG_TEXT, SECT_TEXT).second;
-
-  auto textAddr = textSect->addr;
-  auto textData = mCtx.convertAddrP(textAddr);
-
-  for (auto it = disasm.instructionsBegin(); it != disasm.instructionsEnd();
-       it++) {
-    const auto &inst = *it;
+  funcTracker.load();
+  const auto &functions = funcTracker.getFunctions();
+  if (functions.empty()) {
+    return;
+  }
+  dataInCode = mCtx.getDataInCode();
+  const auto threads = delegate.eCtx.options.threads;
+
+  // Split the text by functions, each part can be fixed independently
+  const auto boundaries = funcTracker.partition(
+      functions.front().address,
+      functions.back().address + functions.back().size, threads);
+  const auto partsCount = boundaries.size() - 1;
+
+  std::vector<std::vector<Callsite>> callsites(partsCount);
+  Utils::parallelFor(partsCount, threads, [&](std::size_t i) {
+    callsites[i] = scanCallsites(boundaries[i], boundaries[i + 1]);
+  });
+  activity.update();
+
+  /**
+   * Resolving targets writes to the accelerator, so it is done serially
+   * beforehand. Afterwards the targets are only read.
+   */
+  std::unordered_map<PtrT, CallsiteTarget> targets;
+  for (const auto &part : callsites) {
+    for (const auto &callsite : part) {
+      if (!targets.contains(callsite.target)) {
+        targets.emplace(callsite.target, resolveCallsite(callsite.target));
+        activity.update();
+      }
+    }
+  }
 
-    // only look for arm immediate branch instructions
-    const bool isBL = inst.id == ARM_INS_BL;
-    const bool isBLX = inst.id == ARM_INS_BLX;
-    const bool isB = inst.id == ARM_INS_B;
-    if (isBL || isBLX || isB) {
-      if (inst.size != 4) {
+  // Logs are collected per part, and emitted in address order
+  const bool shouldLog = logger->should_log(spdlog::level::debug);
+  std::vector<std::vector<std::string>> logs(partsCount);
+  Utils::parallelFor(partsCount, threads, [&](std::size_t i) {
+    for (const auto &callsite : callsites[i]) {
+      const auto &target = targets.at(callsite.target);
+      if (fixCallsite(callsite, target) || !target.names || !shouldLog) {
         continue;
       }
 
-      // get the branch target
-      if (inst.opStr.find(",") != std::string::npos || inst.opStr[0] != '#') {
-        // only want direct branches with imm, no registers
+      const auto &symbols = target.names->symbols;
+      std::string symbolNames;
+      for (auto it = symbols.cbegin(); it != std::prev(symbols.cend()); it++) {
+        symbolNames += it->name + ", ";
+      }
+      symbolNames += symbols.crbegin()->name;
+
+      logs[i].push_back(
+          fmt::format("Unable to find stub for branch at {:#x}, with target "
+                      "{:#x}, with symbols {}.",
+                      callsite.addr, callsite.target, symbolNames));
+    }
+  });
+
+  for (const auto &partLogs : logs) {
+    for (const auto &msg : partLogs) {
+      SPDLOG_LOGGER_DEBUG(logger, "{}", msg);
+    }
+  }
+}
+
+std::vector<ArmFixer::Callsite> ArmFixer::scanCallsites(PtrT startAddr,
+                                                        PtrT endAddr) const {
+  // Data in code offsets are relative to the text segment
+  const auto textAddr = (PtrT)mCtx.getSegment(SEG_TEXT)->command->vmaddr;
+  const auto textData = mCtx.convertAddrP(textAddr);
+
+  const auto &functions = funcTracker.getFunctions();
+  auto funcComp = [](const auto &func, PtrT addr) {
+    return func.address < addr;
+  };
+  auto begin = std::lower_bound(functions.cbegin(), functions.cend(),
+                                startAddr, funcComp);
+  auto end = std::lower_bound(begin, functions.cend(), endAddr, funcComp);
+
+  /**
+   * Walk each function by halfwords. A first halfword of 0b11101, 0b11110, or
+   * 0b11111 starts a 32 bit instruction, everything else is 16 bits. Only 32
+   * bit instructions can be direct branches out of the image.
+   */
+  std::vector<Callsite> callsites;
+  for (auto func = begin; func != end; func++) {
+    auto offset = (uint32_t)(func->address - textAddr);
+    const auto funcEnd = offset + (uint32_t)func->size;
+
+    // The first data in code entry that ends after the start of the function
+    auto data = std::upper_bound(
+        dataInCode.cbegin(), dataInCode.cend(), offset,
+        [](uint32_t off, const auto &e) { return off < e.offset + e.length; });
+
+    while (offset + 2 <= funcEnd) {
+      if (data != dataInCode.cend() && offset >= data->offset) {
+        offset = std::max(offset, data->offset + data->length);
+        data++;
         continue;
       }
 
-      uint32_t brTarget;
-      try {
-        brTarget = std::stoi(inst.opStr.substr(1), nullptr, 16);
-      } catch (std::invalid_argument const &) {
+      const auto hw1 = *(uint16_t *)(textData + offset);
+      if ((hw1 & 0xE000) != 0xE000 || (hw1 & 0x1800) == 0) {
+        offset += 2;
         continue;
       }
 
-      if (mCtx.containsAddr(brTarget)) {
+      // A 32 bit instruction can't run into data or the next function
+      const auto dataStart =
+          data != dataInCode.cend() ? data->offset : UINT32_MAX;
+      if (offset + 4 > funcEnd || offset + 4 > dataStart) {
+        offset += 2;
         continue;
       }
 
-      auto iAddr = (uint32_t)inst.address;
-      auto iLoc = (uint32_t *)(textData + (iAddr - textAddr));
-      auto iLocAligned = (uint32_t *)(textData + (iAddr - 2 - textAddr));
+      const auto iAddr = textAddr + offset;
+      const auto iLoc = (uint32_t *)(textData + offset);
+      offset += 4;
 
-      auto fTarget = armUtils.resolveStubChain(brTarget);
-      auto names = symbolizer.symbolizeAddr(fTarget & -4);
-      if (!names) {
-        // Too many edge cases for meaningful diagnostics
+      // get the branch target, only direct branches with an imm
+      const auto branch = armUtils.decodeThumbBranch(iAddr, *iLoc);
+      if (!branch || mCtx.containsAddr(branch->target)) {
         continue;
       }
 
-      // Try to find a stub
-      bool fixed = false;
-      for (const auto &name : names->symbols) {
-        if (reverseStubMap.contains(name.name)) {
-          const auto stubAddr = *reverseStubMap[name.name].begin();
-
-          uint32_t newInstruction;
-          int32_t displacement = stubAddr - (iAddr + 4);
-          if (isBL || isBLX) {
-            newInstruction = 0xC000F000;
-            if (iAddr & 0x2) {
-              displacement += 2;
-            }
-          } else {
-            newInstruction = 0x9000F000;
-          }
+      callsites.emplace_back(iAddr, branch->target, iLoc, branch->link);
+    }
+  }
 
-          uint32_t s = (uint32_t)(displacement >> 24) & 0x1;
-          uint32_t i1 = (uint32_t)(displacement >> 23) & 0x1;
-          uint32_t i2 = (uint32_t)(displacement >> 22) & 0x1;
-          uint32_t imm10 = (uint32_t)(displacement >> 12) & 0x3FF;
-          uint32_t imm11 = (uint32_t)(displacement >> 1) & 0x7FF;
-          uint32_t j1 = (i1 == s);
-          uint32_t j2 = (i2 == s);
-          uint32_t nextDisp = (j1 << 13) | (j2 << 11) | imm11;
-          uint32_t firstDisp = (s << 10) | imm10;
-          newInstruction |= (nextDisp << 16) | firstDisp;
-
-          *iLoc = newInstruction;
-          fixed = true;
-        }
-      }
-      if (fixed) {
-        activity.update();
-        continue;
-      } else {
-        const auto &symbols = names->symbols;
-        std::string symbolNames;
-        for (auto it = symbols.cbegin(); it != std::prev(symbols.cend());
-             it++) {
-          symbolNames += it->name + ", ";
-        }
-        symbolNames += symbols.crbegin()->name;
+  return callsites;
+}
 
-        SPDLOG_LOGGER_DEBUG(
-            logger,
-            "Unable to find stub for branch at {:#x}, with target "
-            "{:#x}, with symbols {}.",
-            iAddr, brTarget, symbolNames);
-      }
+ArmFixer::CallsiteTarget ArmFixer::resolveCallsite(PtrT brTarget) {
+  auto fTarget = armUtils.resolveStubChain(brTarget);
+
+  // Most branches go to a function that a stub also goes to
+  if (auto it = targetStubMap.find(fTarget); it != targetStubMap.end()) {
+    return {nullptr, it->second};
+  }
+
+  // Otherwise try to match a stub by its symbols
+  auto names = symbolizer.symbolizeAddr(fTarget & -4);
+  if (!names) {
+    // Too many edge cases for meaningful diagnostics
+    return {nullptr, std::nullopt};
+  }
+
+  // Try to find a stub, the last matching symbol takes precedence
+  std::optional<PtrT> stubAddr;
+  for (const auto &name : names->symbols) {
+    if (auto it = reverseStubMap.find(name.name); it != reverseStubMap.end()) {
+      stubAddr = *it->second.begin();
+    }
+  }
+
+  return {names, stubAddr};
+}
+
+bool ArmFixer::fixCallsite(const Callsite &callsite,
+                           const CallsiteTarget &target) const {
+  if (!target.stub) {
+    return false;
+  }
+
+  const auto iAddr = callsite.addr;
+  const auto stubAddr = *target.stub;
+
+  uint32_t newInstruction;
+  int32_t displacement = stubAddr - (iAddr + 4);
+  if (callsite.link) {
+    newInstruction = 0xC000F000;
+    if (iAddr & 0x2) {
+      displacement += 2;
     }
+  } else {
+    newInstruction = 0x9000F000;
   }
+
+  uint32_t s = (uint32_t)(displacement >> 24) & 0x1;
+  uint32_t i1 = (uint32_t)(displacement >> 23) & 0x1;
+  uint32_t i2 = (uint32_t)(displacement >> 22) & 0x1;
+  uint32_t imm10 = (uint32_t)(displacement >> 12) & 0x3FF;
+  uint32_t imm11 = (uint32_t)(displacement >> 1) & 0x7FF;
+  uint32_t j1 = (i1 == s);
+  uint32_t j2 = (i2 == s);
+  uint32_t nextDisp = (j1 << 13) | (j2 << 11) | imm11;
+  uint32_t firstDisp = (s << 10) | imm10;
+  newInstruction |= (nextDisp << 16) | firstDisp;
+
+  *callsite.loc = newInstruction;
+  return true;
 }
 
 void ArmFixer::addStubInfo(PtrT addr, Provider::SymbolicInfo info) {
@@ -3,6 +3,7 @@
 
 #include "ArmUtils.h"
 #include "SymbolPointerCache.h"
+#include <unordered_map>
 
 namespace DyldExtractor::Converter::Stubs {
 
@@ -31,12 +32,29 @@ private:
     uint8_t *loc; // Writable location of the stub
   };
 
+  struct Callsite {
+    PtrT addr;
+    PtrT target;   // Branch target, outside of the image
+    uint32_t *loc; // Writable location of the branch
+    bool link;     // If the branch is a BL or BLX
+  };
+
+  struct CallsiteTarget {
+    const Provider::SymbolicInfo *names;
+    std::optional<PtrT> stub; // Stub to branch to instead
+  };
+
   void fixStubHelpers();
   void scanStubs();
   void fixPass1();
   void fixPass2();
   void fixCallsites();
 
+  std::vector<Callsite> scanCallsites(PtrT startAddr, PtrT endAddr) const;
+  CallsiteTarget resolveCallsite(PtrT brTarget);
+  bool fixCallsite(const Callsite &callsite,
+                   const CallsiteTarget &target) const;
+
   void addStubInfo(PtrT sAddr, Provider::SymbolicInfo info);
 
   Fixer<A> &delegate;
@@ -44,7 +62,7 @@ private:
   Provider::ActivityLogger &activity;
   std::shared_ptr<spdlog::logger> logger;
   Provider::BindInfo<P> &bindInfo;
-  Provider::Disassembler<A> &disasm;
+  Provider::FunctionTracker<P> &funcTracker;
   Provider::PointerTracker<P> &ptrTracker;
   Provider::Symbolizer<A> &symbolizer;
   Provider::SymbolTableTracker<P> &stTracker;
@@ -56,7 +74,13 @@ private:
            std::less<const std::string>>
       reverseStubMap;
 
+  /// Maps the function a stub resolves to, to the first stub that does so.
+  std::unordered_map<PtrT, PtrT> targetStubMap;
+
   std::list<StubInfo> brokenStubs;
+
+  /// Data in code entries, sorted by offset.
+  std::vector<data_in_code_entry> dataInCode;
 };
 
 } // namespace DyldExtractor::Converter::Stubs
@@ -1,5 +1,7 @@
 #include "ArmUtils.h"
 
+#include <Utils/Utils.h>
+
 using namespace DyldExtractor;
 using namespace Converter;
 using namespace Stubs;
@@ -15,6 +17,57 @@ ArmUtils::ArmUtils(const Dyld::Context &dCtx,
       {StubFormat::resolver, [this](PtrT a) { return getResolverTarget(a); }}};
 }
 
+std::optional<ArmUtils::ThumbBranch>
+ArmUtils::decodeThumbBranch(const PtrT addr, const uint32_t instr) {
+  const uint32_t hw1 = instr & 0xFFFF;
+  const uint32_t hw2 = instr >> 16;
+  if ((hw1 & 0xF800) != 0xF000 || (hw2 & 0x8000) != 0x8000) {
+    return std::nullopt;
+  }
+
+  const uint32_t s = (hw1 >> 10) & 0x1;
+  const uint32_t j1 = (hw2 >> 13) & 0x1;
+  const uint32_t j2 = (hw2 >> 11) & 0x1;
+  const uint32_t imm11 = hw2 & 0x7FF;
+
+  switch (hw2 & 0xD000) {
+  case 0x8000: {
+    // B<c>.W, a condition of 0b111x is a different instruction
+    if ((hw1 & 0x0380) == 0x0380) {
+      return std::nullopt;
+    }
+
+    const uint32_t imm6 = hw1 & 0x3F;
+    const int32_t imm32 = signExtend<int32_t, 21>(
+        (s << 20) | (j2 << 19) | (j1 << 18) | (imm6 << 12) | (imm11 << 1));
+    return ThumbBranch{addr + 4 + imm32, false};
+  }
+
+  case 0x9000:   // B.W
+  case 0xC000:   // BLX
+  case 0xD000: { // BL
+    const uint32_t imm10 = hw1 & 0x3FF;
+    const uint32_t i1 = !(j1 ^ s);
+    const uint32_t i2 = !(j2 ^ s);
+    const int32_t imm32 = signExtend<int32_t, 25>(
+        (s << 24) | (i1 << 23) | (i2 << 22) | (imm10 << 12) | (imm11 << 1));
+
+    if ((hw2 & 0xD000) == 0xC000) {
+      // BLX switches to arm, target is aligned to 4 bytes
+      if (hw2 & 0x1) {
+        return std::nullopt;
+      }
+      return ThumbBranch{((addr + 4) & -4) + imm32, true};
+    }
+
+    return ThumbBranch{addr + 4 + imm32, (hw2 & 0xD000) == 0xD000};
+  }
+
+  default:
+    Utils::unreachable();
+  }
+}
+
 std::optional<ArmUtils::StubBinderInfo>
 ArmUtils::isStubBinder(const PtrT addr) const {
   /**
@@ -30,6 +30,11 @@ public:
     PtrT size;
   };
 
+  struct ThumbBranch {
+    PtrT target;
+    bool link; // If it is a BL or BLX
+  };
+
   ArmUtils(const Dyld::Context &dCtx, Provider::Accelerator<P> &accelerator,
            const Provider::PointerTracker<P> &ptrTracker);
 
@@ -44,6 +49,13 @@ public:
     return s.x = x;
   };
 
+  /// @brief Decode a 32 bit Thumb-2 immediate branch, B<c>.W, B.W, BL, or BLX.
+  /// @param addr The address of the instruction.
+  /// @param instr The instruction, with the first halfword in the low bits.
+  /// @returns The branch, or nullopt if it is not an immediate branch.
+  static std::optional<ThumbBranch> decodeThumbBranch(const PtrT addr,
+                                                      const uint32_t instr);
+
   /// @brief Check if it is a stub binder
   /// @param addr Address to the bind, usually start of the __stub_helper sect.
   /// @returns If it is or not.
@@ -2,6 +2,8 @@
 #include "Stubs.h"
 
 #include <Converter/Linkedit/Linkedit.h>
+#include <Utils/Threading.h>
+#include <algorithm>
 
 using namespace DyldExtractor;
 using namespace Converter;
@@ -28,20 +30,8 @@ Fixer<A>::Fixer(Utils::ExtractionContext<A> &eCtx)
 }
 
 template <class A> void Fixer<A>::fix() {
-  // fill out code regions
   if (accelerator.codeRegions.empty()) {
-    for (auto imageInfo : dCtx.images) {
-      auto ctx = dCtx.createMachoCtx<true, P>(imageInfo);
-      ctx.enumerateSections(
-          [](auto seg, auto sect) {
-            return sect->flags & S_ATTR_SOME_INSTRUCTIONS;
-          },
-          [this](auto seg, auto sect) {
-            accelerator.codeRegions.insert(Provider::Accelerator<P>::CodeRegion(
-                sect->addr, sect->addr + sect->size));
-            return true;
-          });
-    }
+    mapCodeRegions();
   }
 
   checkIndirectEntries();
@@ -58,6 +48,53 @@ template <class A> void Fixer<A>::fix() {
   bindPointers();
 }
 
+/// @brief Fill out the code regions of all images in the cache.
+template <class A> void Fixer<A>::mapCodeRegions() {
+  activity.update(std::nullopt, "Mapping code regions");
+
+  using CodeRegion = typename Provider::Accelerator<P>::CodeRegion;
+  const auto threads = eCtx.options.threads;
+  const auto imagesCount = dCtx.images.size();
+
+  // Size the context cache so that images can be loaded concurrently
+  accelerator.imageCtxs.resize(imagesCount);
+
+  // Each part collects the code sections of a contiguous range of images
+  std::vector<std::vector<CodeRegion>> parts(threads);
+  Utils::parallelFor(threads, threads, [&](std::size_t i) {
+    const auto start = imagesCount * i / threads;
+    const auto end = imagesCount * (i + 1) / threads;
+    for (auto imageI = start; imageI < end; imageI++) {
+      const auto &ctx = accelerator.getImageCtx(dCtx, dCtx.images[imageI]);
+      for (const auto &seg : ctx.segments) {
+        for (const auto sect : seg.sections) {
+          if (sect->flags & S_ATTR_SOME_INSTRUCTIONS) {
+            parts[i].emplace_back(sect->addr, sect->addr + sect->size);
+          }
+        }
+      }
+    }
+  });
+
+  std::vector<CodeRegion> regions;
+  for (const auto &part : parts) {
+    regions.insert(regions.end(), part.begin(), part.end());
+  }
+  std::sort(regions.begin(), regions.end());
+
+  // Merge overlapping and adjacent regions
+  auto &codeRegions = accelerator.codeRegions;
+  codeRegions.clear();
+  for (const auto &region : regions) {
+    if (!codeRegions.empty() && region.start <= codeRegions.back().end) {
+      codeRegions.back().end = std::max(codeRegions.back().end, region.end);
+    } else {
+      codeRegions.push_back(region);
+    }
+  }
+  codeRegions.shrink_to_fit();
+}
+
 /**
  * This checks if all the sections that have indirect symbols entries are synced
  * with the tracked indicies. It also generates redacted indirect symbols for
@@ -71,7 +108,7 @@ template <class A> void Fixer<A>::checkIndirectEntries() {
   bool hasIndirectSyms = false;
 
   /// TODO: Verify adding new indirect sym indicies
-  mCtx.enumerateSections([&](auto seg, auto sect) {
+  mCtx.enumerateSections([&](const auto &seg, auto sect) {
     activity.update();
 
     // Normal case
@@ -146,7 +183,7 @@ template <class A> void Fixer<A>::fixIndirectEntries() {
 
   activity.update(std::nullopt, "Fixing Indirect Symbols");
 
-  mCtx.enumerateSections([&](auto seg, auto sect) {
+  mCtx.enumerateSections([&](const auto &seg, auto sect) {
     switch (sect->flags & SECTION_TYPE) {
     case S_NON_LAZY_SYMBOL_POINTERS:
     case S_LAZY_SYMBOL_POINTERS: {
@@ -266,19 +303,23 @@ template <class A> void Fixer<A>::bindPointers() {
   }
 }
 
-template <class A> bool Fixer<A>::isInCodeRegions(PtrT addr) {
-  if (accelerator.codeRegions.empty()) {
+template <class A> bool Fixer<A>::isInCodeRegions(PtrT addr) const {
+  const auto &codeRegions = accelerator.codeRegions;
+  if (codeRegions.empty()) {
     return false;
   }
 
-  auto upper = accelerator.codeRegions.upper_bound(
-      Provider::Accelerator<P>::CodeRegion(addr, addr));
-  if (upper == accelerator.codeRegions.begin()) {
-    return false;
+  // Find the last region that starts at or before the address, the loop has a
+  // fixed number of iterations and the comparison compiles to a cmov.
+  auto base = codeRegions.data();
+  auto n = codeRegions.size();
+  while (n > 1) {
+    const auto half = n / 2;
+    base = (base[half].start <= addr) ? base + half : base;
+    n -= half;
   }
 
-  const auto &potentialRange = *--upper;
-  return addr >= potentialRange.start && addr < potentialRange.end;
+  return addr >= base->start && addr < base->end;
 }
 
 template class Fixer<Utils::Arch::arm>;
@@ -291,7 +332,10 @@ template <class A> void Converter::fixStubs(Utils::ExtractionContext<A> &eCtx) {
                 std::is_same_v<A, Utils::Arch::arm64_32>) {
     // Load providers
     eCtx.bindInfo.load();
-    eCtx.disasm.load();
+    if constexpr (!std::is_same_v<A, Utils::Arch::arm>) {
+      // ArmFixer scans for callsites without a disassembly
+      eCtx.disasm.load(eCtx.options.threads, eCtx.options.disasmEngine);
+    }
 
     eCtx.activity->update("Stub Fixer", "Starting Up");
     if (!eCtx.symbolizer || !eCtx.leTracker || !eCtx.stTracker) {
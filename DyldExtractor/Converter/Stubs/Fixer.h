@@ -22,11 +22,12 @@ public:
   void fix();
 
 private:
+  void mapCodeRegions();
   void checkIndirectEntries();
   void fixIndirectEntries();
   void bindPointers();
 
-  bool isInCodeRegions(PtrT addr);
+  bool isInCodeRegions(PtrT addr) const;
 
   Utils::ExtractionContext<A> &eCtx;
   const Dyld::Context &dCtx;
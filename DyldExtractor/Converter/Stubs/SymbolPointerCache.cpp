@@ -46,11 +46,11 @@ template <class A> void SymbolPointerCache<A>::scanPointers() {
   activity.update(std::nullopt, "Scanning Symbol Pointers");
 
   mCtx.enumerateSections(
-      [](auto seg, auto sect) {
+      [](const auto &seg, auto sect) {
         return (sect->flags & SECTION_TYPE) == S_NON_LAZY_SYMBOL_POINTERS ||
                (sect->flags & SECTION_TYPE) == S_LAZY_SYMBOL_POINTERS;
       },
-      [this](auto seg, auto sect) {
+      [this](const auto &seg, auto sect) {
         auto pType = getPointerType(sect);
 
         uint32_t indirectI = sect->reserved1;
@@ -69,7 +69,7 @@ template <class A> void SymbolPointerCache<A>::scanPointers() {
             const auto &[strIt, entry] =
                 stTracker.getSymbol(stTracker.indirectSyms.at(indirectI));
             uint64_t ordinal = GET_LIBRARY_ORDINAL(entry.n_desc);
-            symbols.insert({*strIt, ordinal, std::nullopt});
+            symbols.insert({std::string(strIt->str), ordinal, std::nullopt});
           }
 
           // The pointer's target function
@@ -187,6 +187,37 @@ SymbolPointerCache<A>::getPointerInfo(PointerType pType, PtrT addr) const {
   }
 }
 
+template <class A>
+const std::vector<typename SymbolPointerCache<A>::PtrT> &
+SymbolPointerCache<A>::getNamedPointers(PointerType pType,
+                                        const std::string &name) const {
+  static const std::vector<PtrT> none;
+
+  const ReverseMapT *reversePtrs;
+  switch (pType) {
+  case PointerType::normal:
+    reversePtrs = &reverse.normal;
+    break;
+  case PointerType::lazy:
+    reversePtrs = &reverse.lazy;
+    break;
+  case PointerType::auth:
+    reversePtrs = &reverse.auth;
+    break;
+
+  default:
+    Utils::unreachable();
+  }
+
+  auto idIt = symbolIds.find(name);
+  if (idIt == symbolIds.end()) {
+    return none;
+  }
+
+  auto it = reversePtrs->find(idIt->second);
+  return it != reversePtrs->end() ? it->second : none;
+}
+
 template <class A>
 void SymbolPointerCache<A>::addPointerInfo(PointerType pType, PtrT pAddr,
                                            const Provider::SymbolicInfo &info) {
@@ -225,10 +256,21 @@ void SymbolPointerCache<A>::addPointerInfo(PointerType pType, PtrT pAddr,
 
   // add to reverse cache
   for (auto &sym : newInfo->symbols) {
-    (*reversePtrs)[sym.name].insert(pAddr);
+    auto &pointers = (*reversePtrs)[internSymbol(sym.name)];
+    auto it = std::lower_bound(pointers.begin(), pointers.end(), pAddr);
+    if (it == pointers.end() || *it != pAddr) {
+      pointers.insert(it, pAddr);
+    }
   }
 }
 
+template <class A>
+SymbolPointerCache<A>::SymbolId
+SymbolPointerCache<A>::internSymbol(const std::string &name) {
+  return symbolIds.try_emplace(name, (SymbolId)symbolIds.size())
+      .first->second;
+}
+
 template class SymbolPointerCache<Utils::Arch::arm>;
 template class SymbolPointerCache<Utils::Arch::arm64>;
 template class SymbolPointerCache<Utils::Arch::arm64_32>;
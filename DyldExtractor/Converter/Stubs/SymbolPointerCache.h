@@ -5,6 +5,9 @@
 #include "ArmUtils.h"
 #include <Provider/SymbolTableTracker.h>
 #include <Provider/Symbolizer.h>
+#include <Utils/FlatHashMap.h>
+#include <string_view>
+#include <unordered_map>
 
 namespace DyldExtractor::Converter::Stubs {
 
@@ -37,17 +40,25 @@ public:
                    const Provider::SymbolicInfo &info);
   const Provider::SymbolicInfo *getPointerInfo(PointerType pType,
                                                PtrT addr) const;
+  /// @brief Get the pointers that have a symbol
+  /// @returns The pointers sorted by address, possibly empty.
+  const std::vector<PtrT> &getNamedPointers(PointerType pType,
+                                            const std::string &name) const;
+
+  /// @brief ID of an interned symbol name
+  using SymbolId = uint32_t;
 
   /// TODO: Add weak type
-  using PtrMapT = std::map<PtrT, std::shared_ptr<Provider::SymbolicInfo>>;
+  using PtrMapT =
+      Utils::FlatHashMap<PtrT, std::shared_ptr<Provider::SymbolicInfo>>;
   struct {
     PtrMapT normal;
     PtrMapT lazy;
     PtrMapT auth;
   } ptr;
 
-  using ReverseMapT = std::map<std::reference_wrapper<const std::string>,
-                               std::set<PtrT>, std::less<const std::string>>;
+  /// Pointers for each symbol, sorted by address
+  using ReverseMapT = Utils::FlatHashMap<SymbolId, std::vector<PtrT>>;
   struct {
     ReverseMapT normal;
     ReverseMapT lazy;
@@ -69,6 +80,10 @@ public:
 private:
   void addPointerInfo(PointerType pType, PtrT pAddr,
                       const Provider::SymbolicInfo &info);
+  SymbolId internSymbol(const std::string &name);
+
+  /// Symbol names to their IDs, views are of names in the pointer infos.
+  std::unordered_map<std::string_view, SymbolId> symbolIds;
 
   Macho::Context<false, P> &mCtx;
   Provider::ActivityLogger &activity;
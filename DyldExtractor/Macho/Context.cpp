@@ -1,10 +1,38 @@
 #include "Context.h"
 
+#include <algorithm>
+#include <cstring>
 #include <exception>
+#include <optional>
 
 using namespace DyldExtractor;
 using namespace Macho;
 
+namespace {
+
+/// A segment or section name zero padded to 16 bytes, compared as 2 words.
+struct FixedName {
+  uint64_t words[2] = {0, 0};
+
+  /// @brief Pack a name from a load command field. All 16 bytes are kept, so
+  ///   the field must be zero padded after the name.
+  FixedName(const char (&field)[16]) { memcpy(words, field, sizeof(words)); }
+
+  /// @brief Pack a name to search for, up to 16 characters without a null
+  ///   terminator, like load command fields.
+  FixedName(const char *name, const char *tooLongMsg) {
+    const auto size = strnlen(name, 17);
+    if (size > 16) {
+      throw std::invalid_argument(tooLongMsg);
+    }
+    memcpy(words, name, size);
+  }
+
+  bool operator==(const FixedName &) const = default;
+};
+
+} // namespace
+
 MappingInfo::MappingInfo(const dyld_cache_mapping_info *info)
     : address(info->address), size(info->size), fileOffset(info->fileOffset) {}
 
@@ -79,9 +107,14 @@ template <bool ro, class P> Context<ro, P>::~Context() {
 
 template <bool ro, class P>
 Context<ro, P>::Context(Context<ro, P> &&other)
-    : file(other.file), header(other.header), ownFiles(other.ownFiles),
-      filesOpen(other.filesOpen), fileMaps(std::move(other.fileMaps)),
-      files(std::move(other.files)) {
+    : file(other.file), header(other.header),
+      loadCommands(std::move(other.loadCommands)),
+      segments(std::move(other.segments)), headerOffset(other.headerOffset),
+      ownFiles(other.ownFiles), filesOpen(other.filesOpen),
+      fileMaps(std::move(other.fileMaps)), files(std::move(other.files)),
+      lcIndex(std::move(other.lcIndex)),
+      sectionTable(std::move(other.sectionTable)),
+      segmentsByAddr(std::move(other.segmentsByAddr)) {
   other.file = nullptr;
   other.header = nullptr;
   other.ownFiles = false;
@@ -92,11 +125,17 @@ template <bool ro, class P>
 Context<ro, P> &Context<ro, P>::operator=(Context<ro, P> &&other) {
   this->file = other.file;
   this->header = other.header;
+  this->loadCommands = std::move(other.loadCommands);
+  this->segments = std::move(other.segments);
+  this->headerOffset = other.headerOffset;
   this->ownFiles = other.ownFiles;
   this->filesOpen = other.filesOpen;
 
   this->fileMaps = std::move(other.fileMaps);
   this->files = std::move(other.files);
+  this->lcIndex = std::move(other.lcIndex);
+  this->sectionTable = std::move(other.sectionTable);
+  this->segmentsByAddr = std::move(other.segmentsByAddr);
 
   other.file = nullptr;
   other.header = nullptr;
@@ -126,9 +165,31 @@ template <bool ro, class P> void Context<ro, P>::reloadHeader() {
     cmdOff += cmd->cmdsize;
   }
 
+  // Index load commands by ID, keeping their order
+  lcIndex.clear();
+  lcIndex.reserve(loadCommands.size());
+  for (uint32_t i = 0; i < loadCommands.size(); i++) {
+    lcIndex.emplace_back(loadCommands[i]->cmd, i);
+  }
+  std::sort(lcIndex.begin(), lcIndex.end());
+
   for (auto const seg : getAllLCs<Loader::segment_command<P>>()) {
     segments.emplace_back(seg);
   }
+
+  // Index sections and segment ranges
+  sectionTable.clear();
+  segmentsByAddr.clear();
+  for (uint32_t i = 0; i < segments.size(); i++) {
+    for (auto sect : segments[i].sections) {
+      sectionTable.emplace_back(i, sect);
+    }
+    segmentsByAddr.push_back(i);
+  }
+  std::sort(segmentsByAddr.begin(), segmentsByAddr.end(),
+            [this](uint32_t a, uint32_t b) {
+              return segments[a].command->vmaddr < segments[b].command->vmaddr;
+            });
 }
 
 template <bool ro, class P>
@@ -156,13 +217,9 @@ Context<ro, P>::convertAddrP(uint64_t addr) const {
 template <bool ro, class P>
 const SegmentContext<ro, P> *
 Context<ro, P>::getSegment(const char *segName) const {
-  auto nameSize = strlen(segName) + 1;
-  if (nameSize > 16) {
-    throw std::invalid_argument("Segment name is too long.");
-  }
-
+  const FixedName key(segName, "Segment name is too long.");
   for (auto &seg : segments) {
-    if (memcmp(segName, seg.command->segname, nameSize) == 0) {
+    if (FixedName(seg.command->segname) == key) {
       return &seg;
     }
   }
@@ -174,45 +231,54 @@ template <bool ro, class P>
 std::pair<const SegmentContext<ro, P> *,
           const typename SegmentContext<ro, P>::SectionT *>
 Context<ro, P>::getSection(const char *segName, const char *sectName) const {
-  std::size_t segSize = 0;
+  const FixedName sectKey(sectName, "Section name is too long.");
+  std::optional<FixedName> segKey;
   if (segName != nullptr) {
-    segSize = strlen(segName);
-    if (segSize < 16) {
-      // Include null terminator
-      segSize++;
-    } else if (segSize > 16) {
-      throw std::invalid_argument("Segment name is too long.");
-    }
+    segKey.emplace(segName, "Segment name is too long.");
   }
 
-  std::size_t sectSize = strlen(sectName);
-  if (sectSize < 16) {
-    // Include null terminator
-    sectSize++;
-  } else if (sectSize > 16) {
-    throw std::invalid_argument("Section name is too long.");
-  }
-
-  for (auto &seg : segments) {
-    if (segSize == 0 || memcmp(segName, seg.command->segname, segSize) == 0) {
-      for (auto sect : seg.sections) {
-        if (memcmp(sectName, sect->sectname, sectSize) == 0) {
-          return std::make_pair(&seg, sect);
-        }
-      }
+  for (const auto &[segI, sect] : sectionTable) {
+    if (FixedName(sect->sectname) == sectKey &&
+        (!segKey ||
+         FixedName(segments[segI].command->segname) == *segKey)) {
+      return std::make_pair(&segments[segI], sect);
     }
   }
 
   return std::make_pair(nullptr, nullptr);
 }
 
+template <bool ro, class P>
+std::vector<data_in_code_entry> Context<ro, P>::getDataInCode() const {
+  auto dataInCodeCmd =
+      getFirstLC<Loader::linkedit_data_command>({LC_DATA_IN_CODE});
+  if (!dataInCodeCmd) {
+    return {};
+  }
+
+  auto leFile = convertAddr(getSegment(SEG_LINKEDIT)->command->vmaddr).second;
+  auto start = reinterpret_cast<const data_in_code_entry *>(
+      leFile + dataInCodeCmd->dataoff);
+  auto end = start + (dataInCodeCmd->datasize / sizeof(data_in_code_entry));
+
+  std::vector<data_in_code_entry> entries(start, end);
+  std::sort(entries.begin(), entries.end(),
+            [](const auto &a, const auto &b) { return a.offset < b.offset; });
+  return entries;
+}
+
 template <bool ro, class P>
 bool Context<ro, P>::containsAddr(const uint64_t addr) const {
-  /// TODO: Binary search?
-  for (auto &seg : segments) {
-    if (addr >= seg.command->vmaddr &&
-        addr < seg.command->vmaddr + seg.command->vmsize) {
-      return true;
+  // Find the last non empty segment that starts at or before the address.
+  // Empty segments are still indexed, they can grow without a reload.
+  auto it = std::upper_bound(segmentsByAddr.cbegin(), segmentsByAddr.cend(),
+                             addr, [this](uint64_t a, uint32_t i) {
+                               return a < segments[i].command->vmaddr;
+                             });
+  while (it != segmentsByAddr.cbegin()) {
+    const auto seg = segments[*--it].command;
+    if (seg->vmsize) {
+      return addr < seg->vmaddr + seg->vmsize;
     }
   }
 
@@ -223,25 +289,29 @@ template <bool ro, class P>
 std::vector<typename Context<ro, P>::LoadCommandT *>
 Context<ro, P>::_getAllLCs(const uint32_t (&targetCmds)[],
                            std::size_t ncmds) const {
-  auto matchLoadCommands = [&targetCmds, ncmds](uint32_t cmd) {
-    // magic value for load_command, match all.
-    if (ncmds == 2 && targetCmds[0] == 0x00 && targetCmds[1] == 0x00) {
-      return true;
-    }
+  // magic value for load_command, match all.
+  if (ncmds == 2 && targetCmds[0] == 0x00 && targetCmds[1] == 0x00) {
+    return loadCommands;
+  }
 
-    for (int i = 0; i < ncmds; i++) {
-      if (cmd == targetCmds[i]) {
-        return true;
-      }
+  std::vector<uint32_t> indices;
+  for (std::size_t i = 0; i < ncmds; i++) {
+    auto [begin, end] = std::equal_range(
+        lcIndex.cbegin(), lcIndex.cend(), std::make_pair(targetCmds[i], 0u),
+        [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (auto it = begin; it != end; it++) {
+      indices.push_back(it->second);
     }
-    return false;
-  };
+  }
+  if (ncmds > 1) {
+    // Restore load command order
+    std::sort(indices.begin(), indices.end());
+  }
 
   std::vector<LoadCommandT *> lcs;
-  for (auto lc : loadCommands) {
-    if (matchLoadCommands(lc->cmd)) {
-      lcs.push_back(lc);
-    }
+  lcs.reserve(indices.size());
+  for (auto i : indices) {
+    lcs.push_back(loadCommands[i]);
   }
 
   return lcs;
@@ -251,46 +321,34 @@ template <bool ro, class P>
 typename Context<ro, P>::LoadCommandT *
 Context<ro, P>::_getFirstLC(const uint32_t (&targetCmds)[],
                             std::size_t ncmds) const {
-  auto matchLoadCommands = [&targetCmds, ncmds](uint32_t cmd) {
-    // magic value for load_command, match all.
-    if (ncmds == 2 && targetCmds[0] == 0x00 && targetCmds[1] == 0x00) {
-      return true;
-    }
-
-    for (int i = 0; i < ncmds; i++) {
-      if (cmd == targetCmds[i]) {
-        return true;
-      }
-    }
-    return false;
-  };
+  // magic value for load_command, match all.
+  if (ncmds == 2 && targetCmds[0] == 0x00 && targetCmds[1] == 0x00) {
+    return loadCommands.empty() ? nullptr : loadCommands.front();
+  }
 
-  for (auto lc : loadCommands) {
-    if (matchLoadCommands(lc->cmd)) {
-      return lc;
+  // The first of each ID is at its lower bound, take the earliest one
+  auto first = (uint32_t)loadCommands.size();
+  for (std::size_t i = 0; i < ncmds; i++) {
+    auto it = std::lower_bound(lcIndex.cbegin(), lcIndex.cend(),
+                               std::make_pair(targetCmds[i], 0u));
+    if (it != lcIndex.cend() && it->first == targetCmds[i]) {
+      first = std::min(first, it->second);
     }
   }
 
-  return nullptr;
+  return first < loadCommands.size() ? loadCommands[first] : nullptr;
 }
 
 template <bool ro, class P>
 void Context<ro, P>::enumerateSections(EnumerationCallback pred,
                                        EnumerationCallback callback) {
-  for (auto &seg : segments) {
-    for (auto sect : seg.sections) {
-      if (pred(seg, sect)) {
-        if (!callback(seg, sect)) {
-          return;
-        }
-      }
-    }
-  }
+  enumerateSections<EnumerationCallback &, EnumerationCallback &>(pred,
+                                                                   callback);
 }
 
 template <bool ro, class P>
 void Context<ro, P>::enumerateSections(EnumerationCallback callback) {
-  enumerateSections([](...) { return true; }, callback);
+  enumerateSections<EnumerationCallback &>(callback);
 }
 
 template <bool ro, class P>
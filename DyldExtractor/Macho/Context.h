@@ -86,7 +86,9 @@ public:
           std::vector<MappingInfo> mainMappings,
           std::vector<std::tuple<fs::path, std::vector<MappingInfo>>> subFiles);
 
-  /// @brief Reload the header and load commands
+  /// @brief Reload the header and load commands, and rebuild the load
+  /// command, section, and segment indices. Must be called after adding or
+  /// removing load commands.
   void reloadHeader();
 
   /// @brief Convert a vmaddr to it's file offset.
@@ -155,6 +157,10 @@ public:
   std::pair<const SegmentT *, const typename SegmentT::SectionT *>
   getSection(const char *segName, const char *sectName) const;
 
+  /// @brief Read the data in code entries
+  /// @returns The entries sorted by offset, empty if there are none.
+  std::vector<data_in_code_entry> getDataInCode() const;
+
   /// @brief Enumerate all segments
   /// @param pred The predicate used to filter.
   /// @param callback The function to call for each section. Return false to
@@ -167,7 +173,62 @@ public:
   ///     stop.
   void enumerateSections(EnumerationCallback callback);
 
+  /// @brief Enumerate all segments, inlinable version
+  /// @param pred The predicate used to filter, called with the segment and
+  ///     section.
+  /// @param callback The function to call for each section. Return false to
+  ///     stop.
+  template <class Pred, class Callback>
+  void enumerateSections(Pred &&pred, Callback &&callback) {
+    for (auto &seg : segments) {
+      for (auto sect : seg.sections) {
+        if (pred(seg, sect) && !callback(seg, sect)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /// @brief Enumerate all segments, inlinable version
+  /// @param callback The function to call for each section. Return false to
+  ///     stop.
+  template <class Callback> void enumerateSections(Callback &&callback) {
+    for (auto &seg : segments) {
+      for (auto sect : seg.sections) {
+        if (!callback(seg, sect)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /// @brief Enumerate all segments without modifying the context
+  template <class Pred, class Callback>
+  void enumerateSections(Pred &&pred, Callback &&callback) const {
+    for (const auto &seg : segments) {
+      for (const auto sect : seg.sections) {
+        if (pred(seg, sect) && !callback(seg, sect)) {
+          return;
+        }
+      }
+    }
+  }
+
+  /// @brief Enumerate all segments without modifying the context
+  template <class Callback> void enumerateSections(Callback &&callback) const {
+    for (const auto &seg : segments) {
+      for (const auto sect : seg.sections) {
+        if (!callback(seg, sect)) {
+          return;
+        }
+      }
+    }
+  }
+
   /// @brief Check if the address is in the macho file
+  ///
+  /// Segment addresses are indexed by reloadHeader, sizes are read live.
+  ///
   /// @param addr
   /// @returns If the file contains the address
   bool containsAddr(const uint64_t addr) const;
@@ -190,6 +251,14 @@ private:
   // Contains all files and mappings
   std::vector<std::tuple<FileT *, std::vector<MappingInfo>>> files;
 
+  // Indices built by reloadHeader
+  /// Load command IDs and their index in loadCommands, sorted.
+  std::vector<std::pair<uint32_t, uint32_t>> lcIndex;
+  /// All sections and the index of their segment, in load command order.
+  std::vector<std::pair<uint32_t, typename SegmentT::SectionT *>> sectionTable;
+  /// Indices of all segments, sorted by address.
+  std::vector<uint32_t> segmentsByAddr;
+
   std::vector<LoadCommandT *> _getAllLCs(const uint32_t (&targetCmds)[],
                                          std::size_t ncmds) const;
   LoadCommandT *_getFirstLC(const uint32_t (&targetCmds)[],
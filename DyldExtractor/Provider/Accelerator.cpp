@@ -0,0 +1,25 @@
+#include "Accelerator.h"
+
+using namespace DyldExtractor;
+using namespace Provider;
+
+template <class P>
+const Macho::Context<true, P> &
+Accelerator<P>::getImageCtx(const Dyld::Context &dCtx,
+                            const dyld_cache_image_info *imageInfo) {
+  if (imageCtxs.size() != dCtx.images.size()) {
+    imageCtxs.resize(dCtx.images.size());
+  }
+
+  // Images are stored contiguously in the cache header
+  auto &ctx = imageCtxs[imageInfo - dCtx.images.front()];
+  if (!ctx) {
+    ctx = std::make_unique<Macho::Context<true, P>>(
+        dCtx.createMachoCtx<true, P>(imageInfo));
+  }
+
+  return *ctx;
+}
+
+template class Accelerator<Utils::Arch::Pointer32>;
+template class Accelerator<Utils::Arch::Pointer64>;
@@ -1,11 +1,18 @@
 #ifndef __PROVIDER_ACCELERATOR__
 #define __PROVIDER_ACCELERATOR__
 
+#include <Dyld/Context.h>
+#include <Macho/Context.h>
+#include <Utils/FlatHashMap.h>
 #include <dyld/dyld_cache_format.h>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #pragma warning(push)
 #pragma warning(disable : 4267)
@@ -44,6 +51,11 @@ using SymbolizerExportEntryMapT =
     std::unordered_multiset<SymbolizerExportEntry, SymbolizerExportEntry::Hash,
                             SymbolizerExportEntry::KeyEqual>;
 
+/// Exports by address without instruction bits, points into a
+/// SymbolizerExportEntryMapT.
+using SymbolizerExportAddrMapT =
+    std::unordered_multimap<uint64_t, const SymbolizerExportEntry *>;
+
 }; // namespace AcceleratorTypes
 
 /// Accelerate modules when processing more than one image. Single threaded.
@@ -51,10 +63,26 @@ template <class P> class Accelerator {
   using PtrT = P::PtrT;
 
 public:
+  /// Read only contexts of images, by index in Dyld::Context::images. Use
+  /// getImageCtx to access.
+  std::vector<std::unique_ptr<Macho::Context<true, P>>> imageCtxs;
+
   // Provider::Symbolizer
   std::map<std::string, const dyld_cache_image_info *> pathToImage;
   std::map<std::string, AcceleratorTypes::SymbolizerExportEntryMapT>
       exportsCache;
+  std::map<std::string, AcceleratorTypes::SymbolizerExportAddrMapT>
+      exportsAddrCache;
+
+  // Converter::Linkedit::Optimizer
+  struct LocalSymbolsEntry {
+    uint32_t nlistStartIndex;
+    uint32_t nlistCount;
+  };
+  /// Local symbol entries in the symbols cache, by dylibOffset. Built by the
+  /// first image that copies redacted local symbols.
+  std::optional<Utils::FlatHashMap<uint64_t, LocalSymbolsEntry>>
+      localSymbolsEntries;
 
   // Converter::Stubs::Arm64Utils, Converter::Stubs::ArmUtils
   std::map<PtrT, PtrT> arm64ResolvedChains;
@@ -66,11 +94,55 @@ public:
     PtrT end;
     auto operator<=>(const auto &o) const { return start <=> o.start; }
   };
-  std::set<CodeRegion> codeRegions;
+  /// Code sections of all images, sorted and merged.
+  std::vector<CodeRegion> codeRegions;
+
+  // Converter::ObjcFixer::Walker
+  struct ObjcOptInfo {
+    const dyld_cache_image_info *libobjcImage;
+    uint32_t version;
+    std::optional<PtrT> relMethodSelBaseAddr;
+    /// ObjC image indices, by the address of the image's mach header.
+    Utils::FlatHashMap<PtrT, uint16_t> imageIndices;
+  };
+  bool objcOptInfoParsed = false;
+  /// libobjc's optimization info, empty if it could not be read.
+  std::optional<ObjcOptInfo> objcOptInfo;
+
+  struct ObjcClassInfo {
+    const char *name;
+    /// The image with the class in its __objc_classlist
+    const dyld_cache_image_info *image;
+    bool isMetaclass;
+  };
+  struct ObjcProtocolInfo {
+    const char *name;
+    /// The image with the protocol in its __objc_protolist
+    const dyld_cache_image_info *image;
+  };
+  /// ObjC metadata of all images in the cache, by address.
+  struct ObjcIndex {
+    Utils::FlatHashMap<PtrT, ObjcProtocolInfo> protocols;
+    Utils::FlatHashMap<PtrT, ObjcClassInfo> classes;
+  };
+  /// Built by the first image that needs it, then only read.
+  std::optional<ObjcIndex> objcIndex;
 
   Accelerator() = default;
   Accelerator(const Accelerator &) = delete;
   Accelerator &operator=(const Accelerator &) = delete;
+
+  /// @brief Get a read only context of an image, creating it if needed.
+  ///
+  /// Can be called concurrently for different images if imageCtxs is already
+  /// sized to the number of images.
+  ///
+  /// @param dCtx The cache that contains the image.
+  /// @param imageInfo The image, must be one of dCtx.images.
+  /// @returns The cached context.
+  const Macho::Context<true, P> &
+  getImageCtx(const Dyld::Context &dCtx,
+              const dyld_cache_image_info *imageInfo);
 };
 
 }; // namespace DyldExtractor::Provider
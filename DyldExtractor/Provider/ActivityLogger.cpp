@@ -20,21 +20,33 @@ int ActivityLogger::StreamBuffer::overflow(int c) {
   return buffer->sputc(c);
 }
 
+ActivityLogger::StreamSink::StreamSink(std::ostream &output)
+    : output(output) {}
+
+std::mutex &ActivityLogger::StreamSink::getMutex() { return mutex_; }
+
+void ActivityLogger::StreamSink::sink_it_(const spdlog::details::log_msg &msg) {
+  spdlog::memory_buf_t formatted;
+  formatter_->format(msg, formatted);
+  output.write(formatted.data(), (std::streamsize)formatted.size());
+}
+
+void ActivityLogger::StreamSink::flush_() { output.flush(); }
+
 ActivityLogger::ActivityLogger(std::string name, std::ostream &output,
                                bool enableActivity)
     : activityStream(output), loggerStream(&streamBuffer),
       streamBuffer(output.rdbuf()), enableActivity(enableActivity),
       lastActivityUpdate(std::chrono::high_resolution_clock::now()),
       lastElapsedTime(0), startTime(std::chrono::high_resolution_clock::now()) {
-  std::shared_ptr<spdlog::sinks::ostream_sink_st> streamSink;
   if (enableActivity) {
     // Create a logger with the special buffer
-    streamSink = std::make_shared<spdlog::sinks::ostream_sink_st>(loggerStream);
+    streamSink = std::make_shared<StreamSink>(loggerStream);
 
     // preload activity
     update(currentModule, currentMessage, true);
   } else {
-    streamSink = std::make_shared<spdlog::sinks::ostream_sink_st>(output);
+    streamSink = std::make_shared<StreamSink>(output);
   }
 
   logger = std::make_shared<spdlog::logger>(name, streamSink);
@@ -92,6 +104,7 @@ void ActivityLogger::update(std::optional<std::string> moduleName,
   }
 
   if (output.length()) {
+    std::scoped_lock lock(streamSink->getMutex());
     activityStream << output + "\r" << std::flush;
   }
 }
@@ -99,6 +112,7 @@ void ActivityLogger::update(std::optional<std::string> moduleName,
 void ActivityLogger::stopActivity() {
   if (enableActivity) {
     enableActivity = false;
+    std::scoped_lock lock(streamSink->getMutex());
     activityStream << "\n";
   }
 }
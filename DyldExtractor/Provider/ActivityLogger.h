@@ -3,8 +3,10 @@
 
 #include <chrono>
 #include <iostream>
+#include <mutex>
+#include <optional>
 #include <spdlog/logger.h>
-#include <spdlog/sinks/ostream_sink.h>
+#include <spdlog/sinks/base_sink.h>
 
 namespace DyldExtractor::Provider {
 
@@ -29,6 +31,20 @@ class ActivityLogger {
     int overflow(int c);
   };
 
+  /// @brief A thread safe stream sink that shares its lock with the activity
+  ///   indicator, so log lines and activity updates don't interleave.
+  class StreamSink final : public spdlog::sinks::base_sink<std::mutex> {
+  public:
+    explicit StreamSink(std::ostream &output);
+    std::mutex &getMutex();
+
+  private:
+    std::ostream &output;
+
+    void sink_it_(const spdlog::details::log_msg &msg) override;
+    void flush_() override;
+  };
+
 public:
   /// @brief Create a logger with an optional activity indicator.
   /// @param name The name of the logger.
@@ -61,6 +77,7 @@ public:
 
 private:
   std::shared_ptr<spdlog::logger> logger;
+  std::shared_ptr<StreamSink> streamSink;
   std::ostream &activityStream;
   std::ostream loggerStream;
   StreamBuffer streamBuffer;
@@ -142,6 +142,16 @@ BindInfo<P>::BindInfo(const Macho::Context<false, P> &mCtx,
                       Provider::ActivityLogger &activity)
     : mCtx(&mCtx), activity(&activity) {}
 
+template <class P>
+void BindInfo<P>::reset(const Macho::Context<false, P> &mCtx) {
+  this->mCtx = &mCtx;
+  binds.clear();
+  weakBinds.clear();
+  lazyBinds.clear();
+  _hasLazyBinds = false;
+  dataLoaded = false;
+}
+
 template <class P> void BindInfo<P>::load() {
   if (dataLoaded) {
     return;
@@ -42,6 +42,10 @@ public:
 
   bool hasLazyBinds() const;
 
+  /// @brief Clear all records and switch to another image, keeping the
+  ///   buffers.
+  void reset(const Macho::Context<false, P> &mCtx);
+
 private:
   const Macho::Context<false, P> *mCtx;
   Provider::ActivityLogger *activity;
@@ -1,18 +1,24 @@
 #include "Disassembler.h"
 
+#include <Utils/Arm64Decoder.h>
+#include <Utils/Threading.h>
 #include <Utils/Utils.h>
 
 using namespace DyldExtractor;
 using namespace Provider;
 
 template <class A>
-Disassembler<A>::Instruction::Instruction(PtrT addr, uint8_t size)
-    : address(addr), id(DISASM_INVALID_INSN), size(size) {}
+Disassembler<A>::Instruction::Instruction(uint32_t offset, uint8_t size)
+    : offset(offset), id(DISASM_INVALID_INSN), size(size) {}
 
 template <class A>
-Disassembler<A>::Instruction::Instruction(cs_insn *raw)
-    : address((PtrT)raw->address), id(raw->id), size((uint8_t)raw->size),
-      opStr(raw->op_str) {}
+Disassembler<A>::Instruction::Instruction(uint32_t offset, uint16_t id,
+                                          uint8_t size)
+    : offset(offset), id(id), size(size) {}
+
+template <class A>
+Disassembler<A>::Instruction::Instruction(uint32_t offset, const cs_insn *raw)
+    : offset(offset), id((uint16_t)raw->id), size((uint8_t)raw->size) {}
 
 template <class A>
 Disassembler<A>::Disassembler(const Macho::Context<false, P> &mCtx,
@@ -21,33 +27,46 @@ Disassembler<A>::Disassembler(const Macho::Context<false, P> &mCtx,
                               Provider::FunctionTracker<P> &funcTracker)
     : mCtx(&mCtx), activity(&activity), logger(logger),
       funcTracker(&funcTracker) {
+  if constexpr (!std::is_same_v<A, Utils::Arch::x86_64>) {
+    // x86_64 not supported but allow construction
+    handle = openHandle();
+  }
+}
+
+template <class A> Disassembler<A>::~Disassembler() {
+  if (handle) {
+    cs_close(&handle);
+  }
+}
+
+template <class A> csh Disassembler<A>::openHandle() {
   // Create Capstone engine
+  csh h;
   cs_err err;
-  if constexpr (std::is_same_v<A, Utils::Arch::x86_64>) {
-    // x86_64 not supported but allow construction
-    return;
-  } else if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
-    err = cs_open(CS_ARCH_ARM, CS_MODE_THUMB, &handle);
+  if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
+    err = cs_open(CS_ARCH_ARM, CS_MODE_THUMB, &h);
   } else if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
                        std::is_same_v<A, Utils::Arch::arm64_32>) {
-    err = cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &handle);
+    err = cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &h);
   } else {
-    Utils::unreachable();
+    throw std::runtime_error("Unsupported architecture for Capstone.");
   }
 
   if (err != CS_ERR_OK) {
     throw std::runtime_error("Unable to open Capstone engine.");
   }
-}
 
-template <class A> Disassembler<A>::~Disassembler() { cs_close(&handle); }
+  // Only the instruction IDs are needed
+  cs_option(h, CS_OPT_DETAIL, CS_OPT_OFF);
+  return h;
+}
 
 template <class A>
 Disassembler<A>::Disassembler(Disassembler<A> &&o)
     : mCtx(o.mCtx), activity(o.activity), logger(std::move(o.logger)),
       funcTracker(o.funcTracker), instructions(std::move(o.instructions)),
       textData(o.textData), textAddr(o.textAddr), disassembled(o.disassembled),
-      handle(o.handle) {
+      engine(o.engine), handle(o.handle) {
   o.mCtx = nullptr;
   o.activity = nullptr;
   o.funcTracker = nullptr;
@@ -67,6 +86,7 @@ Disassembler<A> &Disassembler<A>::operator=(Disassembler<A> &&o) {
   this->textData = o.textData;
   this->textAddr = o.textAddr;
   this->disassembled = o.disassembled;
+  this->engine = o.engine;
   this->handle = o.handle;
 
   o.mCtx = nullptr;
@@ -79,7 +99,8 @@ Disassembler<A> &Disassembler<A>::operator=(Disassembler<A> &&o) {
   return *this;
 }
 
-template <class A> void Disassembler<A>::load() {
+template <class A>
+void Disassembler<A>::load(unsigned int threads, DisasmEngine engine) {
   if constexpr (std::is_same_v<A, Utils::Arch::x86_64>) {
     throw std::runtime_error("X86_64 disassembly not supported.");
   }
@@ -88,6 +109,11 @@ template <class A> void Disassembler<A>::load() {
     return;
   }
   disassembled = true;
+  // The builtin decoder only supports arm64
+  if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
+                std::is_same_v<A, Utils::Arch::arm64_32>) {
+    this->engine = engine;
+  }
   activity->update("Disassembler", "disassembling (will appear frozen)");
 
   // Get data about text
@@ -96,18 +122,8 @@ template <class A> void Disassembler<A>::load() {
   textAddr = textSeg->vmaddr;
 
   // read all data in code entries
-  auto dataInCodeCmd =
-      mCtx->getFirstLC<Macho::Loader::linkedit_data_command>({LC_DATA_IN_CODE});
-  if (dataInCodeCmd) {
-    auto leFile =
-        mCtx->convertAddr(mCtx->getSegment(SEG_LINKEDIT)->command->vmaddr)
-            .second;
-    data_in_code_entry *start =
-        reinterpret_cast<data_in_code_entry *>(leFile + dataInCodeCmd->dataoff);
-    data_in_code_entry *end =
-        start + (dataInCodeCmd->datasize / sizeof(data_in_code_entry));
-    dataInCodeEntries = {start, end};
-  }
+  const auto dataInCode = mCtx->getDataInCode();
+  dataInCodeEntries = {dataInCode.cbegin(), dataInCode.cend()};
 
   // Arm64 should not have data in code
   if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
@@ -119,11 +135,67 @@ template <class A> void Disassembler<A>::load() {
 
   // Process all functions
   funcTracker->load();
-  for (const auto &func : funcTracker->getFunctions()) {
-    disasmFunc((uint32_t)(func.address - textAddr), (uint32_t)func.size);
+  const auto &functions = funcTracker->getFunctions();
+  if (functions.empty()) {
+    return;
+  }
+
+  // Split functions into contiguous parts, each with their own buffer
+  const auto boundaries = funcTracker->partition(
+      functions.front().address,
+      functions.back().address + functions.back().size, threads);
+  const auto partsCount = boundaries.size() - 1;
+
+  std::vector<InstructionCacheT> parts(partsCount);
+  Utils::parallelFor(partsCount, threads, [&](std::size_t i) {
+    auto funcComp = [](const auto &func, PtrT addr) {
+      return func.address < addr;
+    };
+    auto begin = std::lower_bound(functions.cbegin(), functions.cend(),
+                                  boundaries[i], funcComp);
+    auto end =
+        std::lower_bound(begin, functions.cend(), boundaries[i + 1], funcComp);
+
+    // Capstone engines can't be shared between threads
+    csh h = (partsCount == 1 || this->engine == DisasmEngine::builtin)
+                ? handle
+                : openHandle();
+    for (auto it = begin; it != end; it++) {
+      disasmFunc(h, parts[i], (uint32_t)(it->address - textAddr),
+                 (uint32_t)it->size);
+    }
+    if (h != handle) {
+      cs_close(&h);
+    }
+  });
+
+  // Join parts in address order
+  if (partsCount == 1) {
+    instructions = std::move(parts.front());
+  } else {
+    std::size_t total = 0;
+    for (const auto &part : parts) {
+      total += part.size();
+    }
+
+    instructions.reserve(total);
+    for (const auto &part : parts) {
+      instructions.insert(instructions.end(), part.cbegin(), part.cend());
+    }
   }
 }
 
+template <class A>
+void Disassembler<A>::reset(const Macho::Context<false, P> &mCtx) {
+  this->mCtx = &mCtx;
+  instructions.clear();
+  dataInCodeEntries.clear();
+  textData = nullptr;
+  textAddr = 0;
+  disassembled = false;
+  engine = DisasmEngine::capstone;
+}
+
 template <class A>
 Disassembler<A>::ConstInstructionIt
 Disassembler<A>::instructionAtAddr(PtrT addr) const {
@@ -134,12 +206,13 @@ Disassembler<A>::instructionAtAddr(PtrT addr) const {
 
   if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
     // Must use binary search as instruction sizes are mixed
+    const auto offset = (uint32_t)(addr - textAddr);
     auto it = std::lower_bound(instructions.cbegin(), instructions.cend(),
-                               Instruction(addr, 4),
+                               Instruction(offset, 4),
                                [](const Instruction &a, const Instruction &b) {
-                                 return a.address < b.address;
+                                 return a.offset < b.offset;
                                });
-    if (it == instructions.cend() || it->address != addr) {
+    if (it == instructions.cend() || it->offset != offset) {
       return instructions.cend();
     } else {
       return it;
@@ -147,7 +220,7 @@ Disassembler<A>::instructionAtAddr(PtrT addr) const {
 
   } else if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
                        std::is_same_v<A, Utils::Arch::arm64_32>) {
-    PtrT index = (addr - instructions.cbegin()->address) / 4;
+    PtrT index = (addr - addressOf(*instructions.cbegin())) / 4;
     if (index >= instructions.size()) {
       return instructions.cend();
     }
@@ -169,7 +242,14 @@ Disassembler<A>::ConstInstructionIt Disassembler<A>::instructionsEnd() const {
 }
 
 template <class A>
-void Disassembler<A>::disasmFunc(uint32_t offset, uint32_t size) {
+Disassembler<A>::PtrT
+Disassembler<A>::addressOf(const Instruction &inst) const {
+  return textAddr + inst.offset;
+}
+
+template <class A>
+void Disassembler<A>::disasmFunc(csh h, InstructionCacheT &out,
+                                 uint32_t offset, uint32_t size) const {
   // Find data in code entries in the function
   auto dataInCodeBegin = dataInCodeEntries.lower_bound({offset, 0, 0});
   auto dataInCodeEnd = dataInCodeEntries.lower_bound({offset + size, 0, 0});
@@ -177,33 +257,38 @@ void Disassembler<A>::disasmFunc(uint32_t offset, uint32_t size) {
   uint32_t currOff = offset;
   for (auto it = dataInCodeBegin; it != dataInCodeEnd; it++) {
     uint32_t chunkSize = it->offset - currOff;
-    disasmChunk(currOff, chunkSize);
+    disasmChunk(h, out, currOff, chunkSize);
 
     // Add invalid instruction for data in code
-    instructions.emplace_back(textAddr + it->offset, (uint8_t)it->length);
+    out.emplace_back(it->offset, (uint8_t)it->length);
     currOff += chunkSize + it->length;
   }
 
   // Disassemble to the end of the function
-  disasmChunk(currOff, size - (currOff - offset));
+  disasmChunk(h, out, currOff, size - (currOff - offset));
 }
 
 template <class A>
-void Disassembler<A>::disasmChunk(uint32_t offset, uint32_t size) {
+void Disassembler<A>::disasmChunk(csh h, InstructionCacheT &out,
+                                  uint32_t offset, uint32_t size) const {
+  if (engine == DisasmEngine::builtin) {
+    decodeChunk(out, offset, size);
+    return;
+  }
+
   uint32_t currOff = offset;
   while (currOff < offset + size) {
     cs_insn *rawInsn;
-    auto count =
-        cs_disasm(handle, textData + currOff, size - (currOff - offset),
-                  textAddr + currOff, 0, &rawInsn);
+    auto count = cs_disasm(h, textData + currOff, size - (currOff - offset),
+                           textAddr + currOff, 0, &rawInsn);
     if (count == 0) {
       // Recover and try again
-      currOff += recover(currOff);
+      currOff += recover(out, currOff);
       continue;
     }
 
     for (int i = 0; i < count; i++) {
-      instructions.emplace_back(rawInsn + i);
+      out.emplace_back(currOff, rawInsn + i);
       currOff += (rawInsn + i)->size;
     }
 
@@ -211,13 +296,32 @@ void Disassembler<A>::disasmChunk(uint32_t offset, uint32_t size) {
   }
 }
 
-template <class A> uint32_t Disassembler<A>::recover(uint32_t offset) {
+template <class A>
+void Disassembler<A>::decodeChunk(InstructionCacheT &out, uint32_t offset,
+                                  uint32_t size) const {
+  const uint32_t end = offset + size;
+  uint32_t currOff = offset;
+  for (; currOff + 4 <= end; currOff += 4) {
+    auto raw = *(uint32_t *)(textData + currOff);
+    auto kind = Utils::Arm64Decoder::decode(raw).kind;
+    out.emplace_back(currOff, (uint16_t)kind, (uint8_t)4);
+  }
+
+  // Trailing bytes can't be an instruction
+  while (currOff < end) {
+    currOff += recover(out, currOff);
+  }
+}
+
+template <class A>
+uint32_t Disassembler<A>::recover(InstructionCacheT &out,
+                                  uint32_t offset) const {
   if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
-    instructions.emplace_back(textAddr + offset, 2);
+    out.emplace_back(offset, 2);
     return 2;
   } else if constexpr (std::is_same_v<A, Utils::Arch::arm64> ||
                        std::is_same_v<A, Utils::Arch::arm64_32>) {
-    instructions.emplace_back(textAddr + offset, 4);
+    out.emplace_back(offset, 4);
     return 4;
   } else {
     Utils::unreachable();
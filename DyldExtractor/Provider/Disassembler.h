@@ -12,21 +12,32 @@
 
 namespace DyldExtractor::Provider {
 
+/// @brief The engine used to disassemble functions.
+enum class DisasmEngine {
+  /// Full disassembly, instruction IDs are Capstone IDs.
+  capstone,
+  /// Utils::Arm64Decoder, instruction IDs are Arm64Decoder::Kind values. Much
+  /// faster but only rejects unallocated encoding groups, so it is less
+  /// precise at telling data from code. Falls back to Capstone for non arm64
+  /// architectures.
+  builtin
+};
+
 template <class A> class Disassembler {
   using P = A::P;
   using PtrT = P::PtrT;
 
 public:
+  /// @brief A disassembled instruction, packed to keep the cache small.
   struct Instruction {
-    PtrT address;
-    unsigned int id;
+    uint32_t offset; // Byte offset from the text seg
+    uint16_t id;
     uint8_t size;
 
-    std::string opStr;
-
     /// @brief Create an invalid instruction
-    Instruction(PtrT addr, uint8_t size);
-    Instruction(cs_insn *raw);
+    Instruction(uint32_t offset, uint8_t size);
+    Instruction(uint32_t offset, uint16_t id, uint8_t size);
+    Instruction(uint32_t offset, const cs_insn *raw);
   };
 
   using InstructionCacheT = std::vector<Instruction>;
@@ -42,25 +53,55 @@ public:
   Disassembler &operator=(const Disassembler &) = delete;
   Disassembler &operator=(Disassembler &&o);
 
-  void load();
+  /// @brief Disassemble all functions
+  /// @param threads Maximum number of threads to use. Each thread
+  ///   disassembles a contiguous range of functions with its own handle.
+  /// @param engine The engine to use.
+  void load(unsigned int threads = 1,
+            DisasmEngine engine = DisasmEngine::capstone);
+
+  /// @brief Clear all instructions and switch to another image, keeping the
+  ///   buffer and the Capstone engine.
+  void reset(const Macho::Context<false, P> &mCtx);
+
   ConstInstructionIt instructionAtAddr(PtrT addr) const;
   ConstInstructionIt instructionsBegin() const;
   ConstInstructionIt instructionsEnd() const;
 
+  /// @brief Get the address of an instruction
+  PtrT addressOf(const Instruction &inst) const;
+
 private:
+  /// @brief Open a Capstone engine for the architecture
+  static csh openHandle();
+
   /// @brief Disassemble an entire function
+  /// @param h Capstone engine to use
+  /// @param out Where to place the instructions
   /// @param offset Byte offset from the text seg
   /// @param size Size of function
-  void disasmFunc(uint32_t offset, uint32_t size);
+  void disasmFunc(csh h, InstructionCacheT &out, uint32_t offset,
+                  uint32_t size) const;
 
   /// @brief Disassemble part of a function
+  /// @param h Capstone engine to use
+  /// @param out Where to place the instructions
+  /// @param offset Byte offset from the text seg
+  /// @param size Size of chunk
+  void disasmChunk(csh h, InstructionCacheT &out, uint32_t offset,
+                   uint32_t size) const;
+
+  /// @brief Decode part of a function with the builtin decoder
+  /// @param out Where to place the instructions
   /// @param offset Byte offset from the text seg
   /// @param size Size of chunk
-  void disasmChunk(uint32_t offset, uint32_t size);
+  void decodeChunk(InstructionCacheT &out, uint32_t offset,
+                   uint32_t size) const;
 
   /// @brief Recover from failed disassembly
+  /// @param out Where to place the invalid instruction
   /// @return The size of the recovered instruction
-  uint32_t recover(uint32_t offset);
+  uint32_t recover(InstructionCacheT &out, uint32_t offset) const;
 
   const Macho::Context<false, P> *mCtx;
   Provider::ActivityLogger *activity;
@@ -71,7 +112,8 @@ private:
   uint8_t *textData = nullptr; // text segment data
   PtrT textAddr = 0;           // text segment address
   bool disassembled = false;
-  csh handle;
+  DisasmEngine engine = DisasmEngine::capstone;
+  csh handle = 0;
 
   static inline auto dataInCodeComp = [](const auto &rhs, const auto &lhs) {
     return rhs.offset < lhs.offset;
@@ -10,6 +10,13 @@ FunctionTracker<P>::FunctionTracker(const Macho::Context<false, P> &mCtx,
                                     std::shared_ptr<spdlog::logger> logger)
     : mCtx(&mCtx), logger(logger) {}
 
+template <class P>
+void FunctionTracker<P>::reset(const Macho::Context<false, P> &mCtx) {
+  this->mCtx = &mCtx;
+  loaded = false;
+  functions.clear();
+}
+
 template <class P> void FunctionTracker<P>::load() {
   if (loaded) {
     return;
@@ -46,5 +53,27 @@ FunctionTracker<P>::getFunctions() const {
   return functions;
 }
 
+template <class P>
+std::vector<typename P::PtrT>
+FunctionTracker<P>::partition(PtrT start, PtrT end, unsigned int count) const {
+  std::vector<PtrT> boundaries{start};
+  for (unsigned int i = 1; i < count; i++) {
+    const PtrT target = start + (PtrT)((uint64_t)(end - start) * i / count);
+    auto it = std::lower_bound(
+        functions.cbegin(), functions.cend(), target,
+        [](const Function &f, PtrT addr) { return f.address < addr; });
+    if (it == functions.cend() || it->address >= end) {
+      break;
+    }
+
+    if (it->address > boundaries.back()) {
+      boundaries.push_back(it->address);
+    }
+  }
+
+  boundaries.push_back(end);
+  return boundaries;
+}
+
 template class FunctionTracker<Utils::Arch::Pointer32>;
 template class FunctionTracker<Utils::Arch::Pointer64>;
\ No newline at end of file
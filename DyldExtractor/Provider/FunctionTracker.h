@@ -27,6 +27,19 @@ public:
   void load();
   const std::vector<Function> &getFunctions() const;
 
+  /// @brief Clear all functions and switch to another image, keeping the
+  ///   buffer.
+  void reset(const Macho::Context<false, P> &mCtx);
+
+  /// @brief Split an address range into parts of similar size, only cutting
+  ///   at the start of functions.
+  /// @param start Start of the range.
+  /// @param end End of the range, exclusive.
+  /// @param count Maximum number of parts.
+  /// @returns Boundaries of the parts, starting with start and ending with
+  ///   end. Contains at least 2 elements.
+  std::vector<PtrT> partition(PtrT start, PtrT end, unsigned int count) const;
+
 private:
   const Macho::Context<false, P> *mCtx;
   std::shared_ptr<spdlog::logger> logger;
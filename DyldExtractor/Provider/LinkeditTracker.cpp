@@ -107,6 +107,9 @@ template <class P> Macho::Loader::load_command *LinkeditTracker<P>::lcEnd() {
 }
 
 template <class P> const uint8_t *LinkeditTracker<P>::getData() const {
+  if (deferred) {
+    throw std::logic_error("Linkedit data has uncommitted changes.");
+  }
   return leData;
 }
 
@@ -128,6 +131,23 @@ bool LinkeditTracker<P>::resizeData(MetadataIt metaIt, uint32_t newSize) {
 
   int32_t shiftAmount = newSize - metaIt->dataSize;
 
+  if (deferred) {
+    if (leData + deferredSize + shiftAmount > leDataEnd) {
+      return false;
+    }
+
+    // Resizing zeros any new space
+    auto &buffer = buffers.at(metaIt->tag);
+    buffer.resize(newSize);
+    metaIt->data = buffer.data();
+    metaIt->dataSize = newSize;
+    deferredSize += shiftAmount;
+
+    leSeg->vmsize += shiftAmount;
+    leSeg->filesize += shiftAmount;
+    return true;
+  }
+
   // Check if we have enough space
   if (metadata.crbegin()->end() + shiftAmount > leDataEnd) {
     return false;
@@ -182,6 +202,12 @@ LinkeditTracker<P>::addData(Metadata meta, const uint8_t *const data,
   auto pos = std::lower_bound(
       metadata.begin(), metadata.end(), meta,
       [](const Metadata &a, const Metadata &b) { return a.tag < b.tag; });
+
+  if (deferred) {
+    std::vector<uint8_t> buffer(data, data + copySize);
+    return addDeferred(pos, meta, std::move(buffer));
+  }
+
   auto posDataStart = pos == metadata.end() ? std::prev(pos)->end() : pos->data;
 
   // Get end of all data
@@ -221,7 +247,43 @@ LinkeditTracker<P>::addData(Metadata meta, const uint8_t *const data,
   return std::make_pair(newMetaIt, true);
 }
 
+template <class P>
+std::pair<typename LinkeditTracker<P>::MetadataIt, bool>
+LinkeditTracker<P>::addData(Metadata meta, std::vector<uint8_t> &&data) {
+  if (!deferred) {
+    return addData(meta, data.data(), (uint32_t)data.size());
+  }
+
+  if (meta.dataSize % sizeof(PtrT)) {
+    throw std::invalid_argument(
+        "Data size for the new data region must be pointer aligned.");
+  }
+  if (data.size() > meta.dataSize) {
+    throw std::invalid_argument(
+        "Copy size must be less than or equal to the new data region size.");
+  }
+  if ((uint8_t *)meta.offsetField < cmdsData ||
+      (uint8_t *)meta.offsetField + sizeof(uint32_t) > cmdsDataEnd) {
+    throw std::invalid_argument(
+        "Data offset field is outside the load command region.");
+  }
+
+  auto pos = std::lower_bound(
+      metadata.begin(), metadata.end(), meta,
+      [](const Metadata &a, const Metadata &b) { return a.tag < b.tag; });
+  return addDeferred(pos, meta, std::move(data));
+}
+
 template <class P> void LinkeditTracker<P>::removeData(MetadataIt pos) {
+  if (deferred) {
+    deferredSize -= pos->dataSize;
+    leSeg->vmsize -= pos->dataSize;
+    leSeg->filesize -= pos->dataSize;
+    buffers.erase(pos->tag);
+    metadata.erase(pos);
+    return;
+  }
+
   // shift data back
   uint8_t *shiftStart = pos->end();
   uint8_t *shiftEnd = metadata.rbegin()->end();
@@ -335,6 +397,10 @@ template <class P> uint32_t LinkeditTracker<P>::freeLCSpace() const {
 }
 
 template <class P> void LinkeditTracker<P>::changeOffset(uint32_t offset) {
+  if (deferred) {
+    throw std::logic_error("Linkedit data has uncommitted changes.");
+  }
+
   for (auto it = metadata.begin(); it != metadata.end(); it++) {
     *it->offsetField = offset + (uint32_t)(it->data - leData);
   }
@@ -343,6 +409,70 @@ template <class P> void LinkeditTracker<P>::changeOffset(uint32_t offset) {
   leSeg->fileoff = offset;
 }
 
+template <class P> void LinkeditTracker<P>::beginDeferred() {
+  if (deferred) {
+    return;
+  }
+
+  deferred = true;
+  deferredSize = 0;
+  deferredDataEnd = metadata.size() ? metadata.crbegin()->end() : leData;
+  for (auto &meta : metadata) {
+    auto &buffer = buffers[meta.tag];
+    buffer.assign(meta.data, meta.end());
+    meta.data = buffer.data();
+    deferredSize += meta.dataSize;
+  }
+}
+
+template <class P> void LinkeditTracker<P>::commit() {
+  if (!deferred) {
+    return;
+  }
+
+  // Copy each buffer once, in tag order
+  uint8_t *head = leData;
+  for (auto &meta : metadata) {
+    memcpy(head, meta.data, meta.dataSize);
+    meta.data = head;
+    *meta.offsetField = (uint32_t)(leOffset + (head - leData));
+    head += meta.dataSize;
+  }
+
+  // Zero out space that is no longer used
+  if (head < deferredDataEnd) {
+    memset(head, 0, deferredDataEnd - head);
+  }
+
+  buffers.clear();
+  deferredSize = 0;
+  deferredDataEnd = nullptr;
+  deferred = false;
+}
+
+template <class P>
+std::pair<typename LinkeditTracker<P>::MetadataIt, bool>
+LinkeditTracker<P>::addDeferred(MetadataIt pos, Metadata meta,
+                                std::vector<uint8_t> &&data) {
+  if (pos != metadata.end() && pos->tag == meta.tag) {
+    throw std::invalid_argument("Data with the same tag is already tracked.");
+  }
+  if (leData + deferredSize + meta.dataSize > leDataEnd) {
+    return std::make_pair(metadata.end(), false);
+  }
+
+  // Pad with zeros
+  auto &buffer = buffers[meta.tag];
+  buffer = std::move(data);
+  buffer.resize(meta.dataSize);
+  meta.data = buffer.data();
+  deferredSize += meta.dataSize;
+
+  leSeg->vmsize += meta.dataSize;
+  leSeg->filesize += meta.dataSize;
+  return std::make_pair(metadata.insert(pos, meta), true);
+}
+
 template <class P> uint32_t LinkeditTracker<P>::lcOffsetForTag(Tag tag) {
   switch (tag) {
   case Tag::rebase:
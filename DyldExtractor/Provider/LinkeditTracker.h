@@ -2,11 +2,15 @@
 #define __PROVIDER_LINKEDITTRACKER__
 
 #include <Macho/Context.h>
+#include <map>
 
 namespace DyldExtractor::Provider {
 
 /// @brief Manages the linkedit region during extraction. Keeps the load
 /// command offsets synced with the tracked data, unless changeOffset is called.
+///
+/// In deferred mode, tracked data is held in separate buffers and the linkedit
+/// region and offsets are only written when the changes are committed.
 template <class P> class LinkeditTracker {
   using PtrT = P::PtrT;
 
@@ -62,7 +66,8 @@ public:
   Macho::Loader::load_command *lcBegin();
   Macho::Loader::load_command *lcEnd();
 
-  /// @brief Get a pointer to the beginning of Linkedit data.
+  /// @brief Get a pointer to the beginning of Linkedit data. Must not be in
+  ///   deferred mode.
   const uint8_t *getData() const;
 
   /// @brief Find metadata with a tag
@@ -87,6 +92,17 @@ public:
   std::pair<MetadataIt, bool> addData(Metadata meta, const uint8_t *const data,
                                       uint32_t copySize);
 
+  /// @brief Add data into the linkedit, taking ownership of the buffer in
+  ///   deferred mode.
+  /// @param meta The metadata for the data, the data size must be pointer
+  ///   aligned. Data pointer and offset field does not have to be valid.
+  /// @param data The data, its size must be less than or equal to size in
+  ///   meta.
+  /// @return An iterator to the new tracked data, and a boolean indicating if
+  ///   there was enough space for the operation.
+  std::pair<MetadataIt, bool> addData(Metadata meta,
+                                      std::vector<uint8_t> &&data);
+
   /// @brief Remove data from the linkedit
   /// @param pos The data to remove.
   void removeData(MetadataIt pos);
@@ -110,10 +126,20 @@ public:
 
   /// @brief Change the linkedit region offset, doesn't shift any data but load
   ///   commands are updated. Causes de-sync with the load commands, meaning
-  ///   that all offsets in the load commands are invalidated!
+  ///   that all offsets in the load commands are invalidated! Must not be in
+  ///   deferred mode.
   /// @param offset The new offset
   void changeOffset(uint32_t offset);
 
+  /// @brief Enter deferred mode. Tracked data is moved into separate buffers,
+  ///   and adding, resizing, and removing data no longer shifts the linkedit
+  ///   region. Offset fields are not updated until commit.
+  void beginDeferred();
+
+  /// @brief Lay out all tracked data in the linkedit region, update the offset
+  ///   fields, and leave deferred mode. Does nothing if not deferred.
+  void commit();
+
 private:
   Macho::Context<false, P> *mCtx;
   std::vector<Metadata> metadata;
@@ -127,6 +153,14 @@ private:
   uint8_t *cmdsDataEnd; // pointer to the past the end load command
   uint64_t cmdsMaxSize; // Maximum space allowed for load commands
 
+  // Deferred mode
+  bool deferred = false;
+  std::map<Tag, std::vector<uint8_t>> buffers; // Data of each tag
+  uint32_t deferredSize = 0;                   // Total size of tracked data
+  uint8_t *deferredDataEnd = nullptr;          // Data end when deferred began
+
+  std::pair<MetadataIt, bool> addDeferred(MetadataIt pos, Metadata meta,
+                                          std::vector<uint8_t> &&data);
   static uint32_t lcOffsetForTag(Tag tag);
 };
 
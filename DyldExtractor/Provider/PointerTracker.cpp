@@ -1,6 +1,7 @@
 #include "PointerTracker.h"
 
 #include <Utils/ExtractionContext.h>
+#include <algorithm>
 
 using namespace DyldExtractor;
 using namespace Provider;
@@ -20,8 +21,10 @@ PointerTracker<P>::MappingSlideInfo::convertAddr(const uint64_t addr) const {
 template <class P>
 PointerTracker<P>::PointerTracker(
     const Dyld::Context &dCtx,
-    std::optional<std::shared_ptr<spdlog::logger>> logger)
+    std::optional<std::shared_ptr<spdlog::logger>> logger,
+    std::pmr::memory_resource *resource)
     : dCtx(&dCtx), logger(logger) {
+  maps.emplace(resource);
   fillMappings();
 }
 
@@ -78,43 +81,101 @@ PointerTracker<P>::PtrT PointerTracker<P>::slideP(const PtrT addr) const {
 
 template <class P>
 void PointerTracker<P>::add(const PtrT addr, const PtrT target) {
-  pointers[addr] = target;
+  maps->pointers[addr] = target;
 }
 
 template <class P>
 void PointerTracker<P>::addAuth(const PtrT addr, AuthData data) {
-  authData[addr] = data;
+  maps->authData[addr] = data;
 }
 
 template <class P>
 void PointerTracker<P>::copyAuth(const PtrT addr, const PtrT sAddr) {
+  if (auto data = readAuth(sAddr); data) {
+    addAuth(addr, *data);
+  }
+}
+
+template <class P>
+void PointerTracker<P>::copyAuth(const PtrT addr, const PtrT sAddr,
+                                 Batch &batch) const {
+  if (auto data = readAuth(sAddr); data) {
+    batch.addAuth(addr, *data);
+  }
+}
+
+template <class P>
+std::optional<typename PointerTracker<P>::AuthData>
+PointerTracker<P>::readAuth(const PtrT sAddr) const {
   for (const auto mapI : authMappings) {
     const auto &map = mappings.at(mapI);
     if (map.containsAddr(sAddr)) {
 
       auto p = (dyld_cache_slide_pointer3 *)map.convertAddr(sAddr);
       if (p->auth.authenticated) {
-        addAuth(addr,
-                {(uint16_t)p->auth.diversityData,
-                 (bool)p->auth.hasAddressDiversity, (uint8_t)p->auth.key});
+        return AuthData{(uint16_t)p->auth.diversityData,
+                        (bool)p->auth.hasAddressDiversity,
+                        (uint8_t)p->auth.key};
       }
       break;
     }
   }
+
+  return std::nullopt;
 }
 
 template <class P>
 void PointerTracker<P>::removePointers(const PtrT start, const PtrT end) {
   // Remove from pointers, auth, and bind
-  pointers.erase(pointers.lower_bound(start), pointers.upper_bound(end));
-  authData.erase(authData.lower_bound(start), authData.upper_bound(end));
-  bindData.erase(bindData.lower_bound(start), bindData.upper_bound(end));
+  auto eraseRange = [start, end](auto &map) {
+    map.erase(map.lower_bound(start), map.upper_bound(end));
+  };
+  eraseRange(maps->pointers);
+  eraseRange(maps->authData);
+  eraseRange(maps->bindData);
 }
 
 template <class P>
 void PointerTracker<P>::addBind(const PtrT addr,
                                 std::shared_ptr<SymbolicInfo> data) {
-  bindData[addr] = data;
+  maps->bindData[addr] = data;
+}
+
+template <class P> void PointerTracker<P>::merge(Batch &batch) {
+  auto mergeRecords = [](auto &map, auto &records) {
+    if (records.empty()) {
+      return;
+    }
+
+    // Stable so that later records for an address overwrite earlier ones
+    std::stable_sort(
+        records.begin(), records.end(),
+        [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    auto hint = map.lower_bound(records.front().first);
+    for (auto &[addr, data] : records) {
+      hint = std::next(map.insert_or_assign(hint, addr, std::move(data)));
+    }
+    records.clear();
+  };
+
+  mergeRecords(maps->pointers, batch.pointers);
+  mergeRecords(maps->authData, batch.auths);
+  mergeRecords(maps->bindData, batch.binds);
+}
+
+template <class P> void PointerTracker<P>::reset() {
+  maps->pointers.clear();
+  maps->authData.clear();
+  maps->bindData.clear();
+}
+
+template <class P> void PointerTracker<P>::releaseMaps() { maps.reset(); }
+
+template <class P>
+void PointerTracker<P>::reset(std::pmr::memory_resource *resource) {
+  maps.reset();
+  maps.emplace(resource);
 }
 
 template <class P>
@@ -135,24 +196,24 @@ PointerTracker<P>::getSlideMappings() const {
 }
 
 template <class P>
-const std::map<typename PointerTracker<P>::PtrT,
-               typename PointerTracker<P>::PtrT> &
+const std::pmr::map<typename PointerTracker<P>::PtrT,
+                    typename PointerTracker<P>::PtrT> &
 PointerTracker<P>::getPointers() const {
-  return pointers;
+  return maps->pointers;
 }
 
 template <class P>
-const std::map<typename PointerTracker<P>::PtrT,
-               typename PointerTracker<P>::AuthData> &
+const std::pmr::map<typename PointerTracker<P>::PtrT,
+                    typename PointerTracker<P>::AuthData> &
 PointerTracker<P>::getAuths() const {
-  return authData;
+  return maps->authData;
 }
 
 template <class P>
-const std::map<typename PointerTracker<P>::PtrT,
-               std::shared_ptr<SymbolicInfo>> &
+const std::pmr::map<typename PointerTracker<P>::PtrT,
+                    std::shared_ptr<SymbolicInfo>> &
 PointerTracker<P>::getBinds() const {
-  return bindData;
+  return maps->bindData;
 }
 
 template <class P> uint32_t PointerTracker<P>::getPageSize() const {
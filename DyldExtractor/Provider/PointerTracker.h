@@ -4,6 +4,8 @@
 #include "Symbolizer.h"
 #include <Dyld/Context.h>
 #include <map>
+#include <memory_resource>
+#include <optional>
 #include <spdlog/spdlog.h>
 #include <stdint.h>
 #include <vector>
@@ -41,9 +43,40 @@ public:
     const uint8_t *convertAddr(const uint64_t addr) const;
   };
 
+  /// @brief Pointers, auth data, and binds collected to be added at once with
+  ///   merge. Records for the same address overwrite earlier ones.
+  struct Batch {
+    std::vector<std::pair<PtrT, PtrT>> pointers;
+    std::vector<std::pair<PtrT, AuthData>> auths;
+    std::vector<std::pair<PtrT, std::shared_ptr<SymbolicInfo>>> binds;
+
+    void add(const PtrT addr, const PtrT target) {
+      pointers.emplace_back(addr, target);
+    }
+
+    template <class T> void addS(const PtrT addr, const T &data) {
+      for (auto offset : T::PTRS()) {
+        add(addr + (PtrT)offset, *(PtrT *)((uint8_t *)&data + offset));
+      }
+    }
+
+    void addAuth(const PtrT addr, AuthData data) {
+      auths.emplace_back(addr, data);
+    }
+
+    void addBind(const PtrT addr, std::shared_ptr<SymbolicInfo> data) {
+      binds.emplace_back(addr, std::move(data));
+    }
+  };
+
+  /// @brief Create a pointer tracker
+  /// @param dCtx The dyld context
+  /// @param logger Optional logger
+  /// @param resource Memory resource for the tracked pointers.
   PointerTracker(
       const Dyld::Context &dCtx,
-      std::optional<std::shared_ptr<spdlog::logger>> logger = std::nullopt);
+      std::optional<std::shared_ptr<spdlog::logger>> logger = std::nullopt,
+      std::pmr::memory_resource *resource = std::pmr::get_default_resource());
   PointerTracker(const PointerTracker &) = delete;
   PointerTracker &operator=(const PointerTracker &) = delete;
 
@@ -90,28 +123,25 @@ public:
   /// @param sAddr The address of the pointer to copy auth data from
   void copyAuth(const PtrT addr, const PtrT sAddr);
 
+  /// @brief Copy auth data for a pointer into a batch
+  void copyAuth(const PtrT addr, const PtrT sAddr, Batch &batch) const;
+
   /// @brief Copy and add auth data for a struct
   /// @tparam T The type of struct
   /// @param addr The address of the struct
   /// @param sAddr The address to copy auth data from
   template <class T> void copyAuthS(PtrT addr, PtrT sAddr) {
-    // Check if the source address is within an auth mapping
-    for (const auto mapI : authMappings) {
-      const auto &map = mappings.at(mapI);
-      if (map.containsAddr(sAddr)) {
-        // Copy auth data for each pointer if needed
-        auto sLoc = map.convertAddr(sAddr);
-        for (auto offset : T::PTRS()) {
-          auto p = (dyld_cache_slide_pointer3 *)(sLoc + offset);
-          if (p->auth.authenticated) {
-            addAuth(addr + (PtrT)offset,
-                    {(uint16_t)p->auth.diversityData,
-                     (bool)p->auth.hasAddressDiversity, (uint8_t)p->auth.key});
-          }
-        }
-        break;
-      }
-    }
+    forEachAuth<T>(sAddr, [&](PtrT offset, AuthData data) {
+      addAuth(addr + offset, data);
+    });
+  }
+
+  /// @brief Copy auth data for a struct into a batch
+  template <class T>
+  void copyAuthS(PtrT addr, PtrT sAddr, Batch &batch) const {
+    forEachAuth<T>(sAddr, [&](PtrT offset, AuthData data) {
+      batch.addAuth(addr + offset, data);
+    });
   }
 
   /// @brief Remove pointers from tracking, and all maps
@@ -124,23 +154,63 @@ public:
   /// @param data Symbolic info for the bind
   void addBind(const PtrT addr, std::shared_ptr<SymbolicInfo> data);
 
+  /// @brief Add all records in a batch, and clear it.
+  /// @details Records are sorted first, so that they can be inserted next to
+  ///   each other instead of searching the maps for each one.
+  void merge(Batch &batch);
+
+  /// @brief Stop tracking all pointers, keeping the mappings.
+  void reset();
+
+  /// @brief Destroy the maps, so that the memory resource they were built on
+  ///   can be released. Even empty maps may hold memory from it. The tracker
+  ///   must be reset with a resource before it is used again.
+  void releaseMaps();
+
+  /// @brief Stop tracking all pointers, and rebuild the maps on a memory
+  ///   resource. Keeps the mappings.
+  void reset(std::pmr::memory_resource *resource);
+
   /// @brief Get all mappings
   const std::vector<MappingSlideInfo> &getMappings() const;
 
   /// @brief Get all mappings with slide info
   std::vector<const MappingSlideInfo *> getSlideMappings() const;
 
-  const std::map<PtrT, PtrT> &getPointers() const;
+  const std::pmr::map<PtrT, PtrT> &getPointers() const;
 
-  const std::map<PtrT, AuthData> &getAuths() const;
+  const std::pmr::map<PtrT, AuthData> &getAuths() const;
 
-  const std::map<PtrT, std::shared_ptr<SymbolicInfo>> &getBinds() const;
+  const std::pmr::map<PtrT, std::shared_ptr<SymbolicInfo>> &getBinds() const;
 
   /// @brief Get the page size.
   uint32_t getPageSize() const;
 
 private:
   void fillMappings();
+  std::optional<AuthData> readAuth(const PtrT sAddr) const;
+
+  /// @brief Call a function with the offset and auth data of each
+  ///   authenticated pointer in a struct.
+  template <class T, class F> void forEachAuth(PtrT sAddr, F &&func) const {
+    // Check if the source address is within an auth mapping
+    for (const auto mapI : authMappings) {
+      const auto &map = mappings.at(mapI);
+      if (map.containsAddr(sAddr)) {
+        auto sLoc = map.convertAddr(sAddr);
+        for (auto offset : T::PTRS()) {
+          auto p = (dyld_cache_slide_pointer3 *)(sLoc + offset);
+          if (p->auth.authenticated) {
+            func((PtrT)offset,
+                 AuthData{(uint16_t)p->auth.diversityData,
+                          (bool)p->auth.hasAddressDiversity,
+                          (uint8_t)p->auth.key});
+          }
+        }
+        break;
+      }
+    }
+  }
 
   const Dyld::Context *dCtx;
   std::optional<std::shared_ptr<spdlog::logger>> logger;
@@ -149,9 +219,16 @@ private:
   std::vector<int> slideMappings;
   std::vector<int> authMappings;
 
-  std::map<PtrT, PtrT> pointers;
-  std::map<PtrT, AuthData> authData;
-  std::map<PtrT, std::shared_ptr<SymbolicInfo>> bindData;
+  struct Maps {
+    std::pmr::map<PtrT, PtrT> pointers;
+    std::pmr::map<PtrT, AuthData> authData;
+    std::pmr::map<PtrT, std::shared_ptr<SymbolicInfo>> bindData;
+
+    Maps(std::pmr::memory_resource *resource)
+        : pointers(resource), authData(resource), bindData(resource) {}
+  };
+  /// Only empty between releaseMaps and reset.
+  std::optional<Maps> maps;
 };
 
 }; // namespace DyldExtractor::Provider
@@ -6,32 +6,38 @@ using namespace DyldExtractor;
 using namespace Provider;
 
 template <class P>
-const std::string &SymbolTableTracker<P>::addString(const std::string &str) {
-  return *strings.insert(str).first;
+const typename SymbolTableTracker<P>::StringT &
+SymbolTableTracker<P>::addString(std::string_view str) {
+  return strings.add(str);
+}
+
+template <class P>
+const typename SymbolTableTracker<P>::StringT &
+SymbolTableTracker<P>::addExternalString(std::string_view str) {
+  return strings.addExternal(str);
 }
 
 template <class P>
 SymbolTableTracker<P>::SymbolIndex
-SymbolTableTracker<P>::addSym(SymbolType type, const std::string &str,
+SymbolTableTracker<P>::addSym(SymbolType type, const StringT &str,
                               const Macho::Loader::nlist<P> &sym) {
-  auto it = strings.find(str);
   uint32_t index;
   switch (type) {
   case SymbolType::other:
     index = (uint32_t)syms.other.size();
-    syms.other.emplace_back(it, sym);
+    syms.other.emplace_back(&str, sym);
     break;
   case SymbolType::local:
     index = (uint32_t)syms.local.size();
-    syms.local.emplace_back(it, sym);
+    syms.local.emplace_back(&str, sym);
     break;
   case SymbolType::external:
     index = (uint32_t)syms.external.size();
-    syms.external.emplace_back(it, sym);
+    syms.external.emplace_back(&str, sym);
     break;
   case SymbolType::undefined:
     index = (uint32_t)syms.undefined.size();
-    syms.undefined.emplace_back(it, sym);
+    syms.undefined.emplace_back(&str, sym);
     break;
   default:
     Utils::unreachable();
@@ -41,8 +47,29 @@ SymbolTableTracker<P>::addSym(SymbolType type, const std::string &str,
 }
 
 template <class P>
-const std::pair<std::set<std::string>::const_iterator, Macho::Loader::nlist<P>>
-    &SymbolTableTracker<P>::getSymbol(const SymbolIndex &index) const {
+void SymbolTableTracker<P>::reserveSyms(SymbolType type, std::size_t count) {
+  switch (type) {
+  case SymbolType::other:
+    syms.other.reserve(syms.other.size() + count);
+    break;
+  case SymbolType::local:
+    syms.local.reserve(syms.local.size() + count);
+    break;
+  case SymbolType::external:
+    syms.external.reserve(syms.external.size() + count);
+    break;
+  case SymbolType::undefined:
+    syms.undefined.reserve(syms.undefined.size() + count);
+    break;
+  default:
+    Utils::unreachable();
+  }
+}
+
+template <class P>
+const std::pair<const typename SymbolTableTracker<P>::StringT *,
+                Macho::Loader::nlist<P>> &
+SymbolTableTracker<P>::getSymbol(const SymbolIndex &index) const {
   switch (index.first) {
   case SymbolType::other:
     return syms.other.at(index.second);
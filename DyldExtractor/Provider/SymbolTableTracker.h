@@ -2,9 +2,9 @@
 #define __PROVIDER__SYMBOLTABLETRACKER__
 
 #include <Macho/Loader.h>
+#include <Utils/StringPool.h>
 #include <optional>
-#include <set>
-#include <string>
+#include <string_view>
 #include <vector>
 
 namespace DyldExtractor::Provider {
@@ -13,12 +13,13 @@ namespace DyldExtractor::Provider {
 template <class P> class SymbolTableTracker {
 public:
   enum class SymbolType { other, local, external, undefined };
-  using StringCache = std::set<std::string>;
+  using StringCache = Utils::StringPool;
+  using StringT = Utils::StringPool::Entry;
   using SymbolIndex = std::pair<SymbolType, uint32_t>;
 
   struct SymbolCaches {
-    using SymbolCacheT = std::vector<
-        std::pair<StringCache::const_iterator, Macho::Loader::nlist<P>>>;
+    using SymbolCacheT =
+        std::vector<std::pair<const StringT *, Macho::Loader::nlist<P>>>;
     SymbolCacheT other;
     SymbolCacheT local;
     SymbolCacheT external;
@@ -32,20 +33,32 @@ public:
   SymbolTableTracker &operator=(SymbolTableTracker &&) = default;
 
   /// @brief Add a string
-  const std::string &addString(const std::string &str);
+  /// @returns The interned string, with its offset in the string pool.
+  const StringT &addString(std::string_view str);
+
+  /// @brief Add a string without copying it
+  /// @param str The string, must outlive the tracker. For example a string in
+  ///   a mapped cache file that is not modified.
+  /// @returns The interned string, with its offset in the string pool.
+  const StringT &addExternalString(std::string_view str);
 
   /// @brief Add a symbol
   /// @param type The type of symbol, string index does not have to be valid
-  /// @param str The string associated with the symbol, must already be added
+  /// @param str The string associated with the symbol, from addString
   /// @param sym The symbol metadata
   /// @returns The symbol type and index pair.
-  SymbolIndex addSym(SymbolType type, const std::string &str,
+  SymbolIndex addSym(SymbolType type, const StringT &str,
                      const Macho::Loader::nlist<P> &sym);
 
-  const std::pair<StringCache::const_iterator, Macho::Loader::nlist<P>> &
+  /// @brief Reserve space for symbols of a type
+  /// @param type The type of symbol
+  /// @param count The number of symbols that will be added
+  void reserveSyms(SymbolType type, std::size_t count);
+
+  const std::pair<const StringT *, Macho::Loader::nlist<P>> &
   getSymbol(const SymbolIndex &index) const;
 
-  /// @brief Get tracked strings
+  /// @brief Get tracked strings, in string pool order
   const StringCache &getStrings() const;
 
   /// @brief Get tracked symbols
@@ -79,41 +79,59 @@ Symbolizer<A>::Symbolizer(const Dyld::Context &dCtx,
                           Provider::Accelerator<P> &accelerator,
                           Provider::ActivityLogger &activity,
                           std::shared_ptr<spdlog::logger> logger,
-                          const Provider::SymbolTableTracker<P> &stTracker)
+                          const Provider::SymbolTableTracker<P> &stTracker,
+                          bool lazy, std::pmr::memory_resource *resource)
     : dCtx(&dCtx), mCtx(&mCtx), accelerator(&accelerator), activity(&activity),
-      logger(logger), stTracker(&stTracker) {
+      logger(logger), stTracker(&stTracker), symbols(resource), lazy(lazy) {
   activity.update(std::nullopt, "Enumerating Symbols");
-  enumerateExports();
+
+  // Populate accelerator's pathToImage if needed
+  if (accelerator.pathToImage.empty()) {
+    for (auto image : dCtx.images) {
+      std::string path((char *)(dCtx.file + image->pathFileOffset));
+      accelerator.pathToImage[path] = image;
+    }
+  }
+
+  if (lazy) {
+    indexExports();
+  } else {
+    enumerateExports();
+  }
   enumerateSymbols();
 }
 
 template <class A>
 const SymbolicInfo *Symbolizer<A>::symbolizeAddr(PtrT addr) const {
-  if (symbols.contains(addr)) {
-    return symbols.at(addr).get();
-  } else {
-    return nullptr;
-  }
+  auto info = findInfo(addr);
+  return info ? info->get() : nullptr;
 }
 
 template <class A> bool Symbolizer<A>::containsAddr(PtrT addr) const {
-  return symbols.contains(addr);
+  return findInfo(addr) != nullptr;
 }
 
 template <class A>
 std::shared_ptr<SymbolicInfo> Symbolizer<A>::shareInfo(PtrT addr) const {
-  return symbols.at(addr);
+  auto info = findInfo(addr);
+  if (!info) {
+    throw std::out_of_range("No symbolic info for address.");
+  }
+  return *info;
 }
 
-template <class A> void Symbolizer<A>::enumerateExports() {
-  // Populate accelerator's pathToImage if needed
-  if (accelerator->pathToImage.empty()) {
-    for (auto image : dCtx->images) {
-      std::string path((char *)(dCtx->file + image->pathFileOffset));
-      accelerator->pathToImage[path] = image;
-    }
+template <class A>
+const std::shared_ptr<SymbolicInfo> *Symbolizer<A>::findInfo(PtrT addr) const {
+  if (lazy && exportsResolved.insert(addr).second) {
+    resolveExports(addr);
   }
 
+  auto it = symbols.find(addr);
+  return it != symbols.end() ? &it->second : nullptr;
+}
+
+template <class A> void Symbolizer<A>::enumerateExports() {
+
   // Process all dylibs including itself.
   auto dylibs = mCtx->getAllLCs<Macho::Loader::dylib_command>();
   for (uint64_t i = 0; i < dylibs.size(); i++) {
@@ -142,6 +160,53 @@ template <class A> void Symbolizer<A>::enumerateExports() {
   }
 }
 
+template <class A> void Symbolizer<A>::indexExports() {
+  // Only get the export indices, the exports are found by address later.
+  auto dylibs = mCtx->getAllLCs<Macho::Loader::dylib_command>();
+  exportIndices.reserve(dylibs.size());
+  for (const auto dylib : dylibs) {
+    activity->update();
+    exportIndices.push_back(&processDylibAddrs(dylib));
+  }
+}
+
+template <class A> void Symbolizer<A>::resolveExports(PtrT addr) const {
+  // Add exports in ordinal order, like enumerateExports
+  std::shared_ptr<SymbolicInfo> info;
+  for (uint64_t i = 0; i < exportIndices.size(); i++) {
+    const auto [begin, end] = exportIndices[i]->equal_range(addr);
+    for (auto it = begin; it != end; it++) {
+      const auto &e = *it->second;
+      if (info) {
+        info->addSymbol({e.entry.name, i, e.entry.info.flags});
+        continue;
+      }
+
+      SymbolicInfo::Encoding enc;
+      if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
+        enc = static_cast<SymbolicInfo::Encoding>(e.address & 3);
+      } else {
+        enc = SymbolicInfo::Encoding::None;
+      }
+      info = std::make_shared<SymbolicInfo>(
+          SymbolicInfo::Symbol{e.entry.name, i, e.entry.info.flags}, enc);
+    }
+  }
+
+  if (!info) {
+    return;
+  }
+
+  // Symbols from the symtab were added before any lookups, place them after
+  if (auto it = symbols.find(addr); it != symbols.end()) {
+    info->symbols.insert(it->second->symbols.begin(),
+                         it->second->symbols.end());
+    it->second = std::move(info);
+  } else {
+    symbols.emplace(addr, std::move(info));
+  }
+}
+
 template <class A> void Symbolizer<A>::enumerateSymbols() {
   const auto symCaches = stTracker->getSymbolCaches();
   processSymbolCache(symCaches.other);
@@ -159,7 +224,8 @@ void Symbolizer<A>::processSymbolCache(
 
     auto addr = sym.n_value;
     if (symbols.contains(addr)) {
-      symbols.at(addr)->addSymbol({*strIt, SELF_LIBRARY_ORDINAL, std::nullopt});
+      symbols.at(addr)->addSymbol(
+          {std::string(strIt->str), SELF_LIBRARY_ORDINAL, std::nullopt});
     } else {
       SymbolicInfo::Encoding enc;
       if constexpr (std::is_same_v<A, Utils::Arch::arm>) {
@@ -169,8 +235,9 @@ void Symbolizer<A>::processSymbolCache(
       }
 
       symbols.emplace(addr, std::make_shared<SymbolicInfo>(
-                                SymbolicInfo::Symbol{
-                                    *strIt, SELF_LIBRARY_ORDINAL, std::nullopt},
+                                SymbolicInfo::Symbol{std::string(strIt->str),
+                                                     SELF_LIBRARY_ORDINAL,
+                                                     std::nullopt},
                                 enc));
     }
 
@@ -202,7 +269,7 @@ typename Symbolizer<A>::EntryMapT &Symbolizer<A>::processDylibCmd(
 
   // process exports
   const auto imageInfo = accelerator->pathToImage.at(dylibPath);
-  const auto dylibCtx = dCtx->createMachoCtx<true, P>(imageInfo);
+  const auto &dylibCtx = accelerator->getImageCtx(*dCtx, imageInfo);
   const auto rawExports = readExports(dylibPath, dylibCtx);
   std::map<uint64_t, std::vector<ExportInfoTrie::Entry>> reExports;
   for (const auto &e : rawExports) {
@@ -268,6 +335,26 @@ typename Symbolizer<A>::EntryMapT &Symbolizer<A>::processDylibCmd(
   return exportsMap;
 }
 
+template <class A>
+const typename Symbolizer<A>::AddrMapT &Symbolizer<A>::processDylibAddrs(
+    const Macho::Loader::dylib_command *dylibCmd) const {
+  const std::string dylibPath(
+      (char *)((uint8_t *)dylibCmd + dylibCmd->dylib.name.offset));
+  if (auto it = accelerator->exportsAddrCache.find(dylibPath);
+      it != accelerator->exportsAddrCache.end()) {
+    return it->second;
+  }
+
+  const auto &exportsMap = processDylibCmd(dylibCmd);
+  auto &addrMap = accelerator->exportsAddrCache[dylibPath];
+  addrMap.reserve(exportsMap.size());
+  for (const auto &e : exportsMap) {
+    addrMap.emplace(e.address & -4, &e);
+  }
+
+  return addrMap;
+}
+
 template <class A>
 std::vector<ExportInfoTrie::Entry>
 Symbolizer<A>::readExports(const std::string &dylibPath,
@@ -7,6 +7,7 @@
 #include <Macho/Context.h>
 #include <Provider/Accelerator.h>
 #include <fmt/format.h>
+#include <memory_resource>
 
 namespace DyldExtractor::Provider {
 
@@ -60,11 +61,19 @@ template <class A> class Symbolizer {
   using PtrT = P::PtrT;
 
 public:
+  /// @brief Create a symbolizer
+  /// @param lazy If exports of dependencies should only be symbolized when an
+  ///   address is looked up. Lookups then update the symbolizer and are not
+  ///   thread safe.
+  /// @param resource Memory resource for the symbol map.
   Symbolizer(const Dyld::Context &dCtx, Macho::Context<false, P> &mCtx,
              Provider::Accelerator<P> &accelerator,
              Provider::ActivityLogger &activity,
              std::shared_ptr<spdlog::logger> logger,
-             const Provider::SymbolTableTracker<P> &stTracker);
+             const Provider::SymbolTableTracker<P> &stTracker,
+             bool lazy = false,
+             std::pmr::memory_resource *resource =
+                 std::pmr::get_default_resource());
   Symbolizer(const Symbolizer &) = delete;
   Symbolizer &operator=(const Symbolizer &) = delete;
 
@@ -85,6 +94,9 @@ public:
 
 private:
   void enumerateExports();
+  void indexExports();
+  void resolveExports(PtrT addr) const;
+  const std::shared_ptr<SymbolicInfo> *findInfo(PtrT addr) const;
   void enumerateSymbols();
   void processSymbolCache(
       const typename Provider::SymbolTableTracker<P>::SymbolCaches::SymbolCacheT
@@ -92,8 +104,11 @@ private:
 
   using ExportEntry = Provider::AcceleratorTypes::SymbolizerExportEntry;
   using EntryMapT = Provider::AcceleratorTypes::SymbolizerExportEntryMapT;
+  using AddrMapT = Provider::AcceleratorTypes::SymbolizerExportAddrMapT;
   EntryMapT &
   processDylibCmd(const Macho::Loader::dylib_command *dylibCmd) const;
+  const AddrMapT &
+  processDylibAddrs(const Macho::Loader::dylib_command *dylibCmd) const;
   std::vector<ExportInfoTrie::Entry>
   readExports(const std::string &dylibPath,
               const Macho::Context<true, P> &dylibCtx) const;
@@ -105,9 +120,16 @@ private:
   std::shared_ptr<spdlog::logger> logger;
   const Provider::SymbolTableTracker<P> *stTracker;
 
-  std::map<PtrT, std::shared_ptr<SymbolicInfo>> symbols;
+  mutable std::pmr::map<PtrT, std::shared_ptr<SymbolicInfo>> symbols;
 
   bool dataLoaded = false;
+
+  // Lazy mode
+  bool lazy;
+  /// Export indices of each dylib command, in ordinal order
+  std::vector<const AddrMapT *> exportIndices;
+  /// Addresses that exports were already resolved for
+  mutable std::unordered_set<PtrT> exportsResolved;
 };
 
 } // namespace DyldExtractor::Provider
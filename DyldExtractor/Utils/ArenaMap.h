@@ -0,0 +1,267 @@
+#ifndef __UTILS_ARENAMAP__
+#define __UTILS_ARENAMAP__
+
+#include "FlatHashMap.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DyldExtractor::Utils {
+
+/// @brief Open addressing map for integer keys, with entries allocated in
+///   chunks.
+///
+/// Entries are constructed in place and never move, so values can be non
+/// movable and referenced by pointer for the lifetime of the map. Iteration is
+/// in insertion order. Erasing is not supported.
+template <class K, class V, std::size_t ChunkSize = 64> class ArenaMap {
+public:
+  using value_type = std::pair<const K, V>;
+
+  template <bool IsConst> class Iterator {
+    using MapT = std::conditional_t<IsConst, const ArenaMap, ArenaMap>;
+
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename ArenaMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer =
+        std::conditional_t<IsConst, const value_type *, value_type *>;
+    using reference =
+        std::conditional_t<IsConst, const value_type &, value_type &>;
+
+    Iterator() = default;
+    Iterator(MapT *map, std::size_t i) : map(map), i(i) {}
+
+    reference operator*() const { return map->entry(i); }
+    pointer operator->() const { return &map->entry(i); }
+    Iterator &operator++() {
+      i++;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto tmp = *this;
+      i++;
+      return tmp;
+    }
+    bool operator==(const Iterator &o) const { return i == o.i; }
+
+  private:
+    MapT *map = nullptr;
+    std::size_t i = 0;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  ArenaMap() = default;
+  ArenaMap(const ArenaMap &) = delete;
+  ArenaMap &operator=(const ArenaMap &) = delete;
+  ~ArenaMap() {
+    for (std::size_t i = 0; i < count; i++) {
+      entry(i).~value_type();
+    }
+  }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, count); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, count); }
+
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  iterator find(K key) {
+    auto it = index.find(key);
+    return it == index.end() ? end() : iterator(this, it->second);
+  }
+
+  const_iterator find(K key) const {
+    auto it = index.find(key);
+    return it == index.end() ? end() : const_iterator(this, it->second);
+  }
+
+  bool contains(K key) const { return index.contains(key); }
+
+  V &at(K key) { return entry(index.at(key)).second; }
+  const V &at(K key) const { return entry(index.at(key)).second; }
+
+  /// @brief Construct a value in place if the key does not exist
+  /// @returns An iterator to the entry, and if it was inserted.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(K key, Args &&...args) {
+    if (auto it = index.find(key); it != index.end()) {
+      return {iterator(this, it->second), false};
+    }
+
+    if (count % ChunkSize == 0) {
+      chunks.push_back(std::make_unique<Chunk>());
+    }
+    new (chunks.back()->data + (count % ChunkSize) * sizeof(value_type))
+        value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+    index.try_emplace(key, (uint32_t)count);
+    return {iterator(this, count++), true};
+  }
+
+private:
+  struct Chunk {
+    alignas(value_type) std::byte data[sizeof(value_type) * ChunkSize];
+  };
+
+  value_type &entry(std::size_t i) {
+    return *std::launder(reinterpret_cast<value_type *>(
+        chunks[i / ChunkSize]->data + (i % ChunkSize) * sizeof(value_type)));
+  }
+
+  const value_type &entry(std::size_t i) const {
+    return *std::launder(reinterpret_cast<const value_type *>(
+        chunks[i / ChunkSize]->data + (i % ChunkSize) * sizeof(value_type)));
+  }
+
+  /// Key to the index of its entry
+  FlatHashMap<K, uint32_t> index;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  std::size_t count = 0;
+};
+
+/// @brief ArenaMap that can be inserted into from multiple threads.
+///
+/// Keys are spread over shards that are locked separately. Iteration is in key
+/// order, so it doesn't depend on which thread inserted first, and must not
+/// overlap with insertion.
+template <class K, class V, std::size_t ShardCount = 16,
+          std::size_t ChunkSize = 16>
+class ConcurrentArenaMap {
+  static_assert((ShardCount & (ShardCount - 1)) == 0,
+                "ShardCount must be a power of 2");
+
+public:
+  using value_type = std::pair<const K, V>;
+
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename ConcurrentArenaMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = value_type *;
+    using reference = value_type &;
+
+  private:
+    using BaseT = typename std::vector<pointer>::const_iterator;
+
+  public:
+
+    iterator() = default;
+    iterator(BaseT it) : it(it) {}
+
+    reference operator*() const { return **it; }
+    pointer operator->() const { return *it; }
+    iterator &operator++() {
+      it++;
+      return *this;
+    }
+    iterator operator++(int) {
+      auto tmp = *this;
+      it++;
+      return tmp;
+    }
+    bool operator==(const iterator &o) const { return it == o.it; }
+
+  private:
+    BaseT it;
+  };
+
+  ConcurrentArenaMap() = default;
+  ConcurrentArenaMap(const ConcurrentArenaMap &) = delete;
+  ConcurrentArenaMap &operator=(const ConcurrentArenaMap &) = delete;
+
+  /// @brief Construct a value in place if the key does not exist. Thread safe.
+  /// @returns A pointer to the entry, and if it was inserted.
+  template <class... Args>
+  std::pair<value_type *, bool> try_emplace(K key, Args &&...args) {
+    auto &shard = shardOf(key);
+    std::scoped_lock lock(shard.mutex);
+    auto [it, inserted] =
+        shard.map.try_emplace(key, std::forward<Args>(args)...);
+    return {&*it, inserted};
+  }
+
+  /// @brief Find an entry. Thread safe.
+  /// @returns A pointer to the entry or a nullptr.
+  value_type *find(K key) {
+    auto &shard = shardOf(key);
+    std::scoped_lock lock(shard.mutex);
+    auto it = shard.map.find(key);
+    return it == shard.map.end() ? nullptr : &*it;
+  }
+
+  std::size_t size() const {
+    std::size_t total = 0;
+    for (const auto &shard : shards) {
+      total += shard.map.size();
+    }
+    return total;
+  }
+  bool empty() const { return size() == 0; }
+
+  iterator begin() {
+    sortEntries();
+    return iterator(sorted.cbegin());
+  }
+  iterator end() {
+    sortEntries();
+    return iterator(sorted.cend());
+  }
+
+private:
+  struct Shard {
+    std::mutex mutex;
+    ArenaMap<K, V, ChunkSize> map;
+  };
+
+  Shard &shardOf(K key) {
+    constexpr unsigned shardBits = std::countr_zero(ShardCount);
+    if constexpr (shardBits == 0) {
+      return shards[0];
+    } else {
+      auto hash = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+      return shards[hash >> (64 - shardBits)];
+    }
+  }
+
+  /// @brief Rebuild the sorted entries if there were insertions.
+  void sortEntries() {
+    if (sorted.size() == size()) {
+      return;
+    }
+
+    sorted.clear();
+    for (auto &shard : shards) {
+      for (auto &entry : shard.map) {
+        sorted.push_back(&entry);
+      }
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const value_type *a, const value_type *b) {
+                return a->first < b->first;
+              });
+  }
+
+  std::array<Shard, ShardCount> shards;
+  std::vector<value_type *> sorted;
+};
+
+} // namespace DyldExtractor::Utils
+
+#endif // __UTILS_ARENAMAP__
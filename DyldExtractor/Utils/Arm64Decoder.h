@@ -0,0 +1,197 @@
+#ifndef __UTILS_ARM64DECODER__
+#define __UTILS_ARM64DECODER__
+
+#include <cstdint>
+
+/// A small table driven AArch64 decoder for the instructions the converters
+/// care about. Everything else is only classified as valid or invalid by its
+/// top level encoding group, which is much cheaper than full disassembly.
+namespace DyldExtractor::Utils::Arm64Decoder {
+
+enum class Kind : uint8_t {
+  invalid = 0, // Must be 0 to match DISASM_INVALID_INSN
+  other,       // Valid, but not decoded any further
+
+  // Branches
+  b,
+  bl,
+  bCond,
+  cbz,
+  cbnz,
+  tbz,
+  tbnz,
+  br,
+  blr,
+  ret,
+  braa,  // BRAA or BRAB
+  braaz, // BRAAZ or BRABZ
+
+  // PC relative addressing
+  adr,
+  adrp,
+
+  // Loads and stores
+  ldrLiteral,
+  loadImm,
+  storeImm,
+};
+
+struct Instruction {
+  Kind kind = Kind::invalid;
+  uint8_t rd = 0;   // Rd, or Rt for loads and stores
+  uint8_t rn = 0;   // Rn, base register for loads and stores
+  uint8_t size = 0; // Access size in bytes for loads and stores
+  /// Byte offset from the instruction for branches, ADR, and literal loads.
+  /// Byte offset of the page for ADRP. Byte offset from the base register for
+  /// immediate loads and stores.
+  int64_t imm = 0;
+};
+
+namespace Detail {
+
+constexpr int64_t signExtend(uint64_t x, unsigned bits) {
+  return (int64_t)(x << (64 - bits)) >> (64 - bits);
+}
+
+constexpr uint32_t bits(uint32_t instr, unsigned hi, unsigned lo) {
+  return (instr >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+/// Valid encoding groups, indexed by op0, bits 28:25.
+constexpr bool validGroups[16] = {
+    false, // 0000, reserved
+    false, // 0001, unallocated
+    false, // 0010, SVE, not supported by Apple hardware
+    false, // 0011, unallocated
+    true,  true, true, true, true, true, true, true,
+    true,  true, true, true};
+
+enum class Format : uint8_t {
+  imm26,      // B, BL
+  imm19,      // B.cond, CBZ, CBNZ
+  imm14,      // TBZ, TBNZ
+  reg,        // BR, BLR, RET, BRAA, BRAAZ
+  adr,        // ADR, ADRP
+  ldrLiteral, // LDR (literal)
+  ldStUImm,   // LDR/STR (unsigned immediate)
+  ldStImm9,   // LDUR/STUR, LDR/STR (pre and post index)
+};
+
+struct Entry {
+  uint32_t mask;
+  uint32_t value;
+  Kind kind;
+  Format format;
+};
+
+/// Checked in order, the first match wins.
+constexpr Entry table[] = {
+    {0xFC000000, 0x14000000, Kind::b, Format::imm26},
+    {0xFC000000, 0x94000000, Kind::bl, Format::imm26},
+    {0xFF000010, 0x54000000, Kind::bCond, Format::imm19},
+    {0x7F000000, 0x34000000, Kind::cbz, Format::imm19},
+    {0x7F000000, 0x35000000, Kind::cbnz, Format::imm19},
+    {0x7F000000, 0x36000000, Kind::tbz, Format::imm14},
+    {0x7F000000, 0x37000000, Kind::tbnz, Format::imm14},
+    {0xFFFFFC1F, 0xD61F0000, Kind::br, Format::reg},
+    {0xFFFFFC1F, 0xD63F0000, Kind::blr, Format::reg},
+    {0xFFFFFC1F, 0xD65F0000, Kind::ret, Format::reg},
+    {0xFFFFF800, 0xD71F0800, Kind::braa, Format::reg},
+    {0xFFFFF81F, 0xD61F081F, Kind::braaz, Format::reg},
+    {0x9F000000, 0x10000000, Kind::adr, Format::adr},
+    {0x9F000000, 0x90000000, Kind::adrp, Format::adr},
+    {0x3B000000, 0x18000000, Kind::ldrLiteral, Format::ldrLiteral},
+    {0x3B000000, 0x39000000, Kind::loadImm, Format::ldStUImm},
+    {0x3B200000, 0x38000000, Kind::loadImm, Format::ldStImm9},
+};
+
+} // namespace Detail
+
+/// @brief Decode an instruction
+/// @param instr The instruction
+/// @returns The decoded instruction, only the fields used by its kind are set.
+constexpr Instruction decode(uint32_t instr) {
+  using namespace Detail;
+
+  Instruction result;
+  if (!validGroups[bits(instr, 28, 25)]) {
+    return result;
+  }
+
+  for (const auto &entry : table) {
+    if ((instr & entry.mask) != entry.value) {
+      continue;
+    }
+
+    result.kind = entry.kind;
+    result.rd = (uint8_t)bits(instr, 4, 0);
+    result.rn = (uint8_t)bits(instr, 9, 5);
+
+    switch (entry.format) {
+    case Format::imm26:
+      result.imm = signExtend(bits(instr, 25, 0) << 2, 28);
+      break;
+    case Format::imm19:
+      result.imm = signExtend(bits(instr, 23, 5) << 2, 21);
+      break;
+    case Format::imm14:
+      result.imm = signExtend(bits(instr, 18, 5) << 2, 16);
+      break;
+    case Format::reg:
+      break;
+
+    case Format::adr: {
+      const uint64_t imm = (bits(instr, 23, 5) << 2) | bits(instr, 30, 29);
+      result.imm = signExtend(imm, 21);
+      if (result.kind == Kind::adrp) {
+        result.imm *= 4096;
+      }
+      break;
+    }
+
+    case Format::ldrLiteral: {
+      const auto opc = bits(instr, 31, 30);
+      if (bits(instr, 26, 26)) {
+        result.size = (uint8_t)(4 << opc); // SIMD and FP
+      } else {
+        result.size = opc == 1 ? 8 : 4;
+      }
+      result.imm = signExtend(bits(instr, 23, 5) << 2, 21);
+      break;
+    }
+
+    case Format::ldStUImm:
+    case Format::ldStImm9: {
+      const auto sizeField = bits(instr, 31, 30);
+      const auto opc = bits(instr, 23, 22);
+      const bool simd = bits(instr, 26, 26);
+
+      bool isLoad;
+      if (simd) {
+        result.size = (uint8_t)((opc & 0x2) ? 16 : 1 << sizeField);
+        isLoad = opc & 0x1;
+      } else {
+        result.size = (uint8_t)(1 << sizeField);
+        isLoad = opc != 0;
+      }
+      result.kind = isLoad ? Kind::loadImm : Kind::storeImm;
+
+      if (entry.format == Format::ldStUImm) {
+        result.imm = (int64_t)bits(instr, 21, 10) * result.size;
+      } else {
+        result.imm = signExtend(bits(instr, 20, 12), 9);
+      }
+      break;
+    }
+    }
+
+    return result;
+  }
+
+  result.kind = Kind::other;
+  return result;
+}
+
+} // namespace DyldExtractor::Utils::Arm64Decoder
+
+#endif // __UTILS_ARM64DECODER__
@@ -12,7 +12,28 @@ ExtractionContext<A>::ExtractionContext(const Dyld::Context &dCtx,
     : dCtx(&dCtx), mCtx(&mCtx), accelerator(&accelerator), activity(&activity),
       logger(activity.getLogger()), bindInfo(mCtx, activity),
       disasm(mCtx, activity, logger, funcTracker),
-      funcTracker(mCtx, logger), ptrTracker(dCtx, logger) {}
+      funcTracker(mCtx, logger), ptrTracker(dCtx, logger, &arena) {}
+
+template <class A>
+void ExtractionContext<A>::reset(Macho::Context<false, P> &mCtx) {
+  this->mCtx = &mCtx;
+
+  // Per image providers are rebuilt by the modules
+  symbolizer.reset();
+  leTracker.reset();
+  stTracker.reset();
+  exObjc.reset();
+
+  bindInfo.reset(mCtx);
+  disasm.reset(mCtx);
+  funcTracker.reset(mCtx);
+
+  // The pointer tracker's maps hold memory from the arena even when empty, so
+  // they are destroyed before it is released and rebuilt after.
+  ptrTracker.releaseMaps();
+  arena.release();
+  ptrTracker.reset(&arena);
+}
 
 template class ExtractionContext<Arch::x86_64>;
 template class ExtractionContext<Arch::arm>;
@@ -13,10 +13,24 @@
 #include <Provider/PointerTracker.h>
 #include <Provider/SymbolTableTracker.h>
 #include <Provider/Symbolizer.h>
+#include <memory_resource>
 #include <spdlog/logger.h>
 
 namespace DyldExtractor::Utils {
 
+/// @brief Options that tune how modules run.
+struct ExtractionOptions {
+  /// @brief Maximum number of threads a module can use, 1 disables threading.
+  unsigned int threads = 1;
+  /// @brief Engine used to disassemble text.
+  Provider::DisasmEngine disasmEngine = Provider::DisasmEngine::capstone;
+  /// @brief Only symbolize exports of dependencies when they are looked up.
+  bool lazySymbols = false;
+  /// @brief Merge strings that are suffixes of other strings in the string
+  ///   pool.
+  bool mergeStrings = false;
+};
+
 template <class A> class ExtractionContext {
   using P = A::P;
 
@@ -26,6 +40,11 @@ public:
   Provider::Accelerator<P> *accelerator;
   Provider::ActivityLogger *activity;
   std::shared_ptr<spdlog::logger> logger;
+  ExtractionOptions options;
+
+  /// @brief Arena for the providers of a single image. Memory is released all
+  ///   at once when the context is reset or destroyed. Not thread safe.
+  std::pmr::monotonic_buffer_resource arena;
 
   Provider::BindInfo<P> bindInfo;
   Provider::Disassembler<A> disasm;
@@ -44,6 +63,12 @@ public:
   ExtractionContext &operator=(const ExtractionContext<A> &other) = delete;
   ExtractionContext(ExtractionContext<A> &&other) = delete;
   ExtractionContext &operator=(ExtractionContext<A> &&other) = delete;
+
+  /// @brief Reuse the context for another image. Providers are cleared
+  ///   instead of reconstructed, so they keep their buffers. The activity
+  ///   logger and options are kept.
+  /// @param mCtx The new image, must outlive the context or the next reset.
+  void reset(Macho::Context<false, P> &mCtx);
 };
 
 };     // namespace DyldExtractor::Utils
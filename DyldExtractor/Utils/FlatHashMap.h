@@ -0,0 +1,144 @@
+#ifndef __UTILS_FLATHASHMAP__
+#define __UTILS_FLATHASHMAP__
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DyldExtractor::Utils {
+
+/// @brief Open addressing hash map for integer keys.
+///
+/// Entries are stored densely in insertion order, and a linear probing table
+/// of indices points into them. Erasing is not supported. Inserting
+/// invalidates iterators and references.
+template <class K, class V> class FlatHashMap {
+  static_assert(std::is_integral_v<K>, "Keys must be integers.");
+
+public:
+  using value_type = std::pair<K, V>;
+  using iterator = std::vector<value_type>::iterator;
+  using const_iterator = std::vector<value_type>::const_iterator;
+
+  iterator begin() { return entries.begin(); }
+  iterator end() { return entries.end(); }
+  const_iterator begin() const { return entries.cbegin(); }
+  const_iterator end() const { return entries.cend(); }
+
+  std::size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
+
+  /// @brief Reserve space for at least n entries
+  void reserve(std::size_t n) {
+    entries.reserve(n);
+    if (n * 2 > slots.size()) {
+      rehash(n * 2);
+    }
+  }
+
+  iterator find(K key) {
+    const auto slot = findSlot(key);
+    return slots.empty() || !slots[slot] ? end()
+                                         : entries.begin() + (slots[slot] - 1);
+  }
+
+  const_iterator find(K key) const {
+    const auto slot = findSlot(key);
+    return slots.empty() || !slots[slot]
+               ? end()
+               : entries.cbegin() + (slots[slot] - 1);
+  }
+
+  bool contains(K key) const { return find(key) != end(); }
+
+  V &at(K key) {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("FlatHashMap::at");
+    }
+    return it->second;
+  }
+
+  const V &at(K key) const {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("FlatHashMap::at");
+    }
+    return it->second;
+  }
+
+  /// @brief Insert a value if the key does not exist
+  /// @returns An iterator to the entry, and if it was inserted.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(K key, Args &&...args) {
+    // Keep the load factor at or below 1/2
+    if ((entries.size() + 1) * 2 > slots.size()) {
+      rehash(std::max<std::size_t>(slots.size() * 2, 16));
+    }
+
+    const auto slot = findSlot(key);
+    if (slots[slot]) {
+      return {entries.begin() + (slots[slot] - 1), false};
+    }
+
+    entries.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+    slots[slot] = (uint32_t)entries.size();
+    return {std::prev(entries.end()), true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(K key, Args &&...args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  V &operator[](K key) { return try_emplace(key).first->second; }
+
+private:
+  /// @brief Multiply by the golden ratio and keep the middle bits, which are
+  ///   then masked to the table size. Spreads aligned addresses over the
+  ///   table.
+  static std::size_t hash(K key) {
+    return (std::size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+
+  /// @brief Find the slot of a key, or the empty slot it would go in
+  std::size_t findSlot(K key) const {
+    if (slots.empty()) {
+      return 0;
+    }
+
+    const auto mask = slots.size() - 1;
+    for (auto slot = hash(key) & mask;; slot = (slot + 1) & mask) {
+      if (!slots[slot] || entries[slots[slot] - 1].first == key) {
+        return slot;
+      }
+    }
+  }
+
+  /// @brief Rebuild the slots with a new size, rounded up to a power of 2
+  void rehash(std::size_t minSize) {
+    std::size_t newSize = 16;
+    while (newSize < minSize) {
+      newSize *= 2;
+    }
+
+    slots.assign(newSize, 0);
+    for (uint32_t i = 0; i < entries.size(); i++) {
+      slots[findSlot(entries[i].first)] = i + 1;
+    }
+  }
+
+  std::vector<value_type> entries;
+  /// Index into entries plus one, 0 is an empty slot.
+  std::vector<uint32_t> slots;
+};
+
+} // namespace DyldExtractor::Utils
+
+#endif // __UTILS_FLATHASHMAP__
@@ -0,0 +1,251 @@
+#ifndef __UTILS_STRINGPOOL__
+#define __UTILS_STRINGPOOL__
+
+#include "Threading.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace DyldExtractor::Utils {
+
+/// @brief Interns strings for a Mach-O string pool.
+///
+/// Strings are bump allocated in chunks along with their null terminators, and
+/// get their offset in the pool when they are first added. The pool starts
+/// with a "\0", so offset 0 is never used by a string. Entries and their
+/// strings never move. Erasing is not supported.
+///
+/// Strings that outlive the pool, like ones in a mapped cache file, can be
+/// added without being copied into the arena.
+class StringPool {
+public:
+  /// @brief An interned string
+  struct Entry {
+    std::string_view str;
+    /// Offset of the string in the pool
+    uint32_t offset;
+    /// Index of the entry, in the order strings were added
+    uint32_t index;
+    std::size_t hash;
+  };
+
+  StringPool() = default;
+  StringPool(const StringPool &) = delete;
+  StringPool(StringPool &&) = default;
+  StringPool &operator=(const StringPool &) = delete;
+  StringPool &operator=(StringPool &&) = default;
+
+  /// @brief Add a string if it is not already interned
+  /// @returns The interned entry.
+  const Entry &add(std::string_view str) { return intern(str, true); }
+
+  /// @brief Add a string if it is not already interned, without copying it.
+  /// @param str The string, must outlive the pool.
+  /// @returns The interned entry.
+  const Entry &addExternal(std::string_view str) { return intern(str, false); }
+
+  /// @brief Find an interned string
+  /// @returns A pointer to the entry or a nullptr.
+  const Entry *find(std::string_view str) const {
+    if (slots.empty()) {
+      return nullptr;
+    }
+
+    const auto slot = findSlot(str, std::hash<std::string_view>{}(str));
+    return slots[slot] ? &entries[slots[slot] - 1] : nullptr;
+  }
+
+  bool contains(std::string_view str) const { return find(str) != nullptr; }
+
+  /// @brief The number of interned strings
+  std::size_t count() const { return entries.size(); }
+
+  /// @brief The size of the pool in bytes, including the leading "\0"
+  uint32_t size() const { return poolSize; }
+
+  /// @brief Write the pool, the destination must have room for size() bytes.
+  void copyTo(uint8_t *dest) const {
+    *dest++ = 0x0;
+    if (!hasExternal) {
+      // The arena is already in pool order
+      for (const auto &chunk : chunks) {
+        memcpy(dest, chunk.data.get(), chunk.used);
+        dest += chunk.used;
+      }
+      return;
+    }
+
+    for (const auto &entry : entries) {
+      memcpy(dest, entry.str.data(), entry.str.size());
+      dest += entry.str.size();
+      *dest++ = 0x0;
+    }
+  }
+
+  /// @brief Lay out the pool with strings that are suffixes of other strings
+  ///   merged into them, like ld64 does. Entry offsets are not used.
+  /// @param threads Maximum number of threads used to sort the strings.
+  /// @returns The pool, and the offset of each string by entry index.
+  std::pair<std::vector<uint8_t>, std::vector<uint32_t>>
+  mergeSuffixes(unsigned int threads) const {
+    // Sort by reversed strings, so suffixes come right before the strings
+    // that end with them.
+    std::vector<uint32_t> order(entries.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    const auto reverseLess = [this](uint32_t a, uint32_t b) {
+      const auto &strA = entries[a].str;
+      const auto &strB = entries[b].str;
+      return std::lexicographical_compare(strA.rbegin(), strA.rend(),
+                                          strB.rbegin(), strB.rend());
+    };
+
+    // Sort runs in parallel, then merge them in pairs
+    const std::size_t runs = std::clamp<std::size_t>(
+        order.size() / MinSortRun, 1, std::max(threads, 1u));
+    const auto runStart = [&](std::size_t run) {
+      return order.begin() + (order.size() * run / runs);
+    };
+    parallelFor(runs, threads, [&](std::size_t run) {
+      std::sort(runStart(run), runStart(run + 1), reverseLess);
+    });
+    for (std::size_t width = 1; width < runs; width *= 2) {
+      const auto merges = (runs - width + (width * 2) - 1) / (width * 2);
+      parallelFor(merges, threads, [&](std::size_t i) {
+        const auto first = i * width * 2;
+        std::inplace_merge(runStart(first), runStart(first + width),
+                           runStart(std::min(first + width * 2, runs)),
+                           reverseLess);
+      });
+    }
+
+    // Place the longest strings first, and merge each suffix into the string
+    // after it.
+    std::vector<uint32_t> offsets(entries.size());
+    std::vector<uint32_t> placed;
+    uint32_t size = 1;
+    const Entry *prev = nullptr;
+    for (auto it = order.crbegin(); it != order.crend(); it++) {
+      const auto &entry = entries[*it];
+      if (prev && prev->str.ends_with(entry.str)) {
+        offsets[*it] = offsets[prev->index] +
+                       (uint32_t)(prev->str.size() - entry.str.size());
+      } else {
+        offsets[*it] = size;
+        size += (uint32_t)entry.str.size() + 1;
+        placed.push_back(*it);
+      }
+      prev = &entry;
+    }
+
+    // Copy strings, null terminators are already zeroed
+    std::vector<uint8_t> pool(size, 0x0);
+    for (const auto i : placed) {
+      memcpy(pool.data() + offsets[i], entries[i].str.data(),
+             entries[i].str.size());
+    }
+    return std::make_pair(std::move(pool), std::move(offsets));
+  }
+
+private:
+  static constexpr std::size_t ChunkSize = 64 * 1024;
+  /// Minimum number of strings in each run sorted by a thread
+  static constexpr std::size_t MinSortRun = 4096;
+
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    std::size_t used;
+    std::size_t capacity;
+  };
+
+  /// @brief Intern a string, copying it into the arena if needed
+  const Entry &intern(std::string_view str, bool copy) {
+    // Keep the load factor at or below 1/2
+    if ((entries.size() + 1) * 2 > slots.size()) {
+      rehash(std::max<std::size_t>(slots.size() * 2, 1024));
+    }
+
+    const auto hash = std::hash<std::string_view>{}(str);
+    const auto slot = findSlot(str, hash);
+    if (slots[slot]) {
+      return entries[slots[slot] - 1];
+    }
+
+    if (!copy) {
+      hasExternal = true;
+    }
+    entries.push_back({copy ? allocate(str) : str, poolSize,
+                       (uint32_t)entries.size(), hash});
+    slots[slot] = (uint32_t)entries.size();
+    poolSize += (uint32_t)str.size() + 1;
+    return entries.back();
+  }
+
+  /// @brief Copy a string with its null terminator into the arena
+  std::string_view allocate(std::string_view str) {
+    const auto size = str.size() + 1;
+    if (chunks.empty() || chunks.back().capacity - chunks.back().used < size) {
+      const auto capacity = std::max(size, ChunkSize);
+      chunks.push_back({std::make_unique<char[]>(capacity), 0, capacity});
+    }
+
+    auto &chunk = chunks.back();
+    char *dest = chunk.data.get() + chunk.used;
+    memcpy(dest, str.data(), str.size());
+    dest[str.size()] = '\0';
+    chunk.used += size;
+    return std::string_view(dest, str.size());
+  }
+
+  /// @brief Find the slot of a string, or the empty slot it would go in
+  std::size_t findSlot(std::string_view str, std::size_t hash) const {
+    const auto mask = slots.size() - 1;
+    for (auto slot = hash & mask;; slot = (slot + 1) & mask) {
+      if (!slots[slot]) {
+        return slot;
+      }
+
+      const auto &entry = entries[slots[slot] - 1];
+      if (entry.hash == hash && entry.str == str) {
+        return slot;
+      }
+    }
+  }
+
+  /// @brief Rebuild the slots with a new size, rounded up to a power of 2
+  void rehash(std::size_t minSize) {
+    std::size_t newSize = 16;
+    while (newSize < minSize) {
+      newSize *= 2;
+    }
+
+    slots.assign(newSize, 0);
+    const auto mask = newSize - 1;
+    for (uint32_t i = 0; i < entries.size(); i++) {
+      auto slot = entries[i].hash & mask;
+      while (slots[slot]) {
+        slot = (slot + 1) & mask;
+      }
+      slots[slot] = i + 1;
+    }
+  }
+
+  std::vector<Chunk> chunks;
+  std::deque<Entry> entries;
+  /// Index into entries plus one, 0 is an empty slot.
+  std::vector<uint32_t> slots;
+  uint32_t poolSize = 1;
+  /// If any entry is not in the arena
+  bool hasExternal = false;
+};
+
+} // namespace DyldExtractor::Utils
+
+#endif // __UTILS_STRINGPOOL__
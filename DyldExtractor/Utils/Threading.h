@@ -0,0 +1,69 @@
+#ifndef __UTILS_THREADING__
+#define __UTILS_THREADING__
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace DyldExtractor::Utils {
+
+/// @brief Run a job for every index in [0, count), possibly concurrently.
+///
+/// Jobs are handed out in index order to at most `threads` threads, the
+/// calling thread included. If any job throws, the exception with the lowest
+/// index is rethrown after all threads have finished.
+///
+/// @param count The number of jobs.
+/// @param threads Maximum number of threads, 1 or less runs serially.
+/// @param job Callable taking the index of the job.
+template <class F>
+void parallelFor(std::size_t count, unsigned int threads, F &&job) {
+  if (threads <= 1 || count <= 1) {
+    for (std::size_t i = 0; i < count; i++) {
+      job(i);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next = 0;
+  std::vector<std::exception_ptr> errors(count);
+  auto worker = [&]() {
+    for (auto i = next++; i < count; i = next++) {
+      try {
+        job(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+
+  const auto workerCount = std::min<std::size_t>(threads, count);
+  std::vector<std::thread> workers;
+  workers.reserve(workerCount - 1);
+  for (std::size_t i = 1; i < workerCount; i++) {
+    try {
+      workers.emplace_back(worker);
+    } catch (const std::system_error &) {
+      // Out of threads, continue with what we have
+      break;
+    }
+  }
+
+  worker();
+  for (auto &thread : workers) {
+    thread.join();
+  }
+
+  for (const auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+} // namespace DyldExtractor::Utils
+
+#endif // __UTILS_THREADING__